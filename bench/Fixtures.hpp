@@ -0,0 +1,44 @@
+#pragma once
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/ScoresTable.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace rankcpp::bench {
+
+// the shapes benchmarked, as (vector count, vector width in bits); each one
+// covers a 128-bit key
+enum Shape : std::int64_t { Shape16x8 = 0, Shape32x4 = 1, Shape8x16 = 2 };
+
+inline auto shapeDimensions(std::int64_t shape) -> Dimensions {
+  switch (shape) {
+  case Shape32x4:
+    return Dimensions(32, 4);
+  case Shape8x16:
+    return Dimensions(8, 16);
+  default:
+    return Dimensions(16, 8);
+  }
+}
+
+// random per-vector probabilities, converted to scores the way an attack would
+inline auto randomScores(Dimensions const &dims, std::uint32_t seed = 1)
+    -> ScoresTable<double> {
+  std::vector<double> scores(dims.scoresCount());
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  std::generate(std::begin(scores), std::end(scores),
+                [&generator, &dist] { return dist(generator); });
+  ScoresTable<double> table(dims, scores);
+  table.normaliseVectors();
+  table.log2();
+  table.abs();
+  return table;
+}
+
+} /* namespace rankcpp::bench */
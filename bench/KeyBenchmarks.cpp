@@ -0,0 +1,118 @@
+#include "Fixtures.hpp"
+
+#include <rankcpp/Dispatch.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/Encoding.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <gsl/span>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace rankcpp::bench {
+
+namespace {
+
+void BM_subkeyValue(benchmark::State &state) {
+  auto const dims = shapeDimensions(state.range(0));
+  std::mt19937 rng(3);
+  auto const key = randomKey<128>(rng);
+  for (auto _ : state) {
+    for (auto const &subkey : dims.asSpans()) {
+      benchmark::DoNotOptimize(key.subkeyValue<std::size_t>(subkey));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(dims.vectorCount()));
+}
+
+void BM_weightForKey(benchmark::State &state) {
+  auto const dims = shapeDimensions(state.range(0));
+  auto const weights =
+      mapToWeight<double, std::uint64_t>(randomScores(dims), 16);
+  std::mt19937 rng(4);
+  auto const key = randomKey<128>(rng);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(weights.weightForKey(key));
+  }
+}
+
+void BM_weightForKeyDispatched(benchmark::State &state) {
+  auto const dims = shapeDimensions(state.range(0));
+  auto const weights =
+      mapToWeight<double, std::uint64_t>(randomScores(dims), 16);
+  std::mt19937 rng(4);
+  auto const key = randomKey<128>(rng);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(weightForKeyDispatched(weights, key));
+  }
+}
+
+void BM_weightsForKeys(benchmark::State &state) {
+  auto const dims = shapeDimensions(state.range(0));
+  auto const weights =
+      mapToWeight<double, std::uint64_t>(randomScores(dims), 16);
+  std::mt19937 rng(5);
+  std::vector<Key<128>> keys(std::size_t{1} << 16U);
+  std::generate(std::begin(keys), std::end(keys),
+                [&rng]() { return randomKey<128>(rng); });
+  std::vector<std::uint64_t> keyWeights(keys.size());
+  for (auto _ : state) {
+    weights.weightsForKeys(gsl::span<Key<128> const>(keys),
+                           gsl::span<std::uint64_t>(keyWeights),
+                           static_cast<std::size_t>(state.range(1)));
+    benchmark::DoNotOptimize(keyWeights.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+}
+
+void BM_hexToBytes(benchmark::State &state) {
+  std::string const hex = "000102030405060708090a0b0c0d0e0f";
+  std::array<std::uint8_t, 16> bytes{};
+  for (auto _ : state) {
+    hexToBytes(hex, gsl::span<std::uint8_t>{bytes});
+    benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(hex.size()));
+}
+
+void BM_parseHexKeys(benchmark::State &state) {
+  std::mt19937 rng(6);
+  std::vector<Key<128>> keys(std::size_t{1} << 16U);
+  std::generate(std::begin(keys), std::end(keys),
+                [&rng]() { return randomKey<128>(rng); });
+  std::ostringstream os;
+  writeHexKeys(os, gsl::span<Key<128> const>(keys));
+  auto const text = os.str();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        parseHexKeys(text, gsl::span<Key<128>>(keys)));
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(text.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_subkeyValue)->Arg(Shape16x8)->Arg(Shape32x4)->Arg(Shape8x16);
+BENCHMARK(BM_weightForKey)->Arg(Shape16x8)->Arg(Shape32x4)->Arg(Shape8x16);
+BENCHMARK(BM_weightForKeyDispatched)
+    ->Arg(Shape16x8)
+    ->Arg(Shape32x4)
+    ->Arg(Shape8x16);
+BENCHMARK(BM_weightsForKeys)
+    ->ArgsProduct({{Shape16x8, Shape32x4, Shape8x16}, {1, 0}});
+BENCHMARK(BM_hexToBytes);
+BENCHMARK(BM_parseHexKeys);
+
+} /* namespace rankcpp::bench */
@@ -0,0 +1,115 @@
+#include "Fixtures.hpp"
+
+#include <rankcpp/BoostBigUint.hpp>
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <random>
+
+namespace rankcpp::bench {
+
+namespace {
+
+using WeightType = std::uint64_t;
+
+// combinations whose DP would need more inner loop additions than this are
+// skipped, so that a plain run of the suite finishes; set
+// RANKCPP_BENCH_MAX_OPERATIONS to another cap, or to 0 for none, to time them
+auto maxOperations() -> double {
+  static double const cap = [] {
+    auto const *const setting = std::getenv("RANKCPP_BENCH_MAX_OPERATIONS");
+    if (setting == nullptr || *setting == '\0') {
+      return 1e9;
+    }
+    auto const value = std::strtod(setting, nullptr);
+    return value > 0 ? value : std::numeric_limits<double>::infinity();
+  }();
+  return cap;
+}
+
+template <typename RankType, typename RankFunction>
+void rankBenchmark(benchmark::State &state, RankFunction &&rankFunction) {
+  auto const dims = shapeDimensions(state.range(0));
+  auto const precisionBits = static_cast<std::uint32_t>(state.range(1));
+  auto const scores = randomScores(dims);
+  auto const weights =
+      mapToWeight<double, WeightType>(scores, precisionBits);
+
+  std::mt19937 rng(2);
+  auto const key = randomKey<128>(rng);
+  auto const keyWeight = weights.weightForKey(key);
+
+  auto const operations = static_cast<double>(dims.subkeyCount(0)) *
+                          static_cast<double>(dims.vectorCount()) *
+                          static_cast<double>(keyWeight);
+  if (operations > maxOperations()) {
+    state.SkipWithError(
+        "exceeds the operation cap; see RANKCPP_BENCH_MAX_OPERATIONS");
+    return;
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rankFunction(keyWeight, weights));
+  }
+  state.counters["keyWeight"] = static_cast<double>(keyWeight);
+  state.counters["operations"] = benchmark::Counter(
+      operations, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename RankType> void BM_rank(benchmark::State &state) {
+  rankBenchmark<RankType>(state, [](auto maxWeight, auto const &weights) {
+    return rank<RankType>(maxWeight, weights);
+  });
+}
+
+template <typename RankType> void BM_rankLowMem(benchmark::State &state) {
+  rankBenchmark<RankType>(state, [](auto maxWeight, auto const &weights) {
+    return rankLowMem<RankType>(maxWeight, weights);
+  });
+}
+
+template <typename RankType> void BM_rankAllWeights(benchmark::State &state) {
+  rankBenchmark<RankType>(state, [](auto maxWeight, auto const &weights) {
+    return rankAllWeights<RankType>(maxWeight, weights);
+  });
+}
+
+// every shape at precisions 8 to 24 bits, in steps of 4
+void shapesAndPrecisions(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"shape", "precision"});
+  for (auto shape : {Shape16x8, Shape32x4, Shape8x16}) {
+    for (std::int64_t precisionBits = 8; precisionBits <= 24;
+         precisionBits += 4) {
+      benchmark->Args({shape, precisionBits});
+    }
+  }
+  benchmark->Unit(benchmark::kMillisecond);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_rank, std::uint64_t)->Apply(shapesAndPrecisions);
+BENCHMARK_TEMPLATE(BM_rank, BoostBigUint<128>)->Apply(shapesAndPrecisions);
+BENCHMARK_TEMPLATE(BM_rank, BoostBigUint<256>)->Apply(shapesAndPrecisions);
+
+BENCHMARK_TEMPLATE(BM_rankLowMem, std::uint64_t)->Apply(shapesAndPrecisions);
+BENCHMARK_TEMPLATE(BM_rankLowMem, BoostBigUint<128>)
+    ->Apply(shapesAndPrecisions);
+BENCHMARK_TEMPLATE(BM_rankLowMem, BoostBigUint<256>)
+    ->Apply(shapesAndPrecisions);
+
+BENCHMARK_TEMPLATE(BM_rankAllWeights, std::uint64_t)
+    ->Apply(shapesAndPrecisions);
+BENCHMARK_TEMPLATE(BM_rankAllWeights, BoostBigUint<128>)
+    ->Apply(shapesAndPrecisions);
+BENCHMARK_TEMPLATE(BM_rankAllWeights, BoostBigUint<256>)
+    ->Apply(shapesAndPrecisions);
+
+} /* namespace rankcpp::bench */
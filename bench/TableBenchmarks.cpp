@@ -0,0 +1,87 @@
+#include "Fixtures.hpp"
+
+#include <rankcpp/ScoresTable.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace rankcpp::bench {
+
+namespace {
+
+void shapes(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgName("shape");
+  for (auto shape : {Shape16x8, Shape32x4, Shape8x16}) {
+    benchmark->Arg(shape);
+  }
+}
+
+void shapesAndPrecisions(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"shape", "precision"});
+  for (auto shape : {Shape16x8, Shape32x4, Shape8x16}) {
+    for (std::int64_t precisionBits = 8; precisionBits <= 24;
+         precisionBits += 4) {
+      benchmark->Args({shape, precisionBits});
+    }
+  }
+}
+
+void BM_mapToWeight(benchmark::State &state) {
+  auto const scores = randomScores(shapeDimensions(state.range(0)));
+  auto const precisionBits = static_cast<std::uint32_t>(state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        mapToWeight<double, std::uint64_t>(scores, precisionBits));
+  }
+}
+
+// each transform is timed on a fresh copy; the copy is excluded
+template <typename Transform>
+void transformBenchmark(benchmark::State &state, Transform &&transform) {
+  auto const original = randomScores(shapeDimensions(state.range(0)));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto table = original;
+    state.ResumeTiming();
+    transform(table);
+    benchmark::DoNotOptimize(table.allScores().data());
+  }
+}
+
+void BM_normaliseVectors(benchmark::State &state) {
+  transformBenchmark(state, [](auto &table) { table.normaliseVectors(); });
+}
+
+void BM_log2(benchmark::State &state) {
+  transformBenchmark(state, [](auto &table) { table.log2(); });
+}
+
+void BM_abs(benchmark::State &state) {
+  transformBenchmark(state, [](auto &table) { table.abs(); });
+}
+
+void BM_translateVectorsToPositive(benchmark::State &state) {
+  transformBenchmark(state,
+                     [](auto &table) { table.translateVectorsToPositive(); });
+}
+
+void BM_mergeVectors(benchmark::State &state) {
+  auto const scores = randomScores(shapeDimensions(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(scores.mergeVectors());
+  }
+}
+
+} // namespace
+
+BENCHMARK(BM_mapToWeight)->Apply(shapesAndPrecisions);
+BENCHMARK(BM_normaliseVectors)->Apply(shapes);
+BENCHMARK(BM_log2)->Apply(shapes);
+BENCHMARK(BM_abs)->Apply(shapes);
+BENCHMARK(BM_translateVectorsToPositive)->Apply(shapes);
+// merging 8x16 would need 8 tables of 2^32 entries
+BENCHMARK(BM_mergeVectors)->Arg(Shape16x8)->Arg(Shape32x4);
+
+} /* namespace rankcpp::bench */
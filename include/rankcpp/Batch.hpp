@@ -0,0 +1,196 @@
+#pragma once
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/Monitor.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/ScoresTable.hpp>
+#include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/Numeric.hpp>
+#include <rankcpp/utils/Parallel.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** \file
+ * \brief Ranking many independent experiments and summarising the results
+ *
+ */
+
+namespace rankcpp {
+
+/**
+ * One attack to be ranked.  Experiments sharing a group (typically the number
+ * of traces they used) are summarised together.
+ */
+template <std::uint32_t KeyLenBits, typename ScoresType = double,
+          class DimensionsType = Dimensions>
+struct Experiment {
+  std::size_t group;
+  Key<KeyLenBits> key;
+  ScoresTable<ScoresType, DimensionsType> scores;
+};
+
+/**
+ * Running summary of the ranks of a group of experiments.  Ranks are counted
+ * as guesses, so a key ranked 0 takes one guess and contributes log2(1) = 0.
+ * A success rate threshold of t bits counts the keys found within 2^t guesses.
+ */
+class RankStatistics {
+public:
+  explicit RankStatistics(std::vector<double> thresholdsBits = {})
+      : thresholdsBits_(std::move(thresholdsBits)),
+        successes_(thresholdsBits_.size()) {}
+
+  // log2Guesses is log2(rank + 1)
+  void add(double log2Guesses) {
+    ++count_;
+    log2GuessesSum_ += log2Guesses;
+    log2GuessesSumExp_ = logAdd2(log2GuessesSumExp_, log2Guesses);
+    for (std::size_t ti = 0; ti < thresholdsBits_.size(); ++ti) {
+      if (log2Guesses <= thresholdsBits_[ti]) {
+        ++successes_[ti];
+      }
+    }
+  }
+
+  void merge(RankStatistics const &other) {
+    if (other.thresholdsBits_ != thresholdsBits_) {
+      throw std::invalid_argument(
+          "cannot merge statistics with different thresholds");
+    }
+    count_ += other.count_;
+    log2GuessesSum_ += other.log2GuessesSum_;
+    log2GuessesSumExp_ =
+        logAdd2(log2GuessesSumExp_, other.log2GuessesSumExp_);
+    for (std::size_t ti = 0; ti < successes_.size(); ++ti) {
+      successes_[ti] += other.successes_[ti];
+    }
+  }
+
+  auto count() const noexcept -> std::size_t { return count_; }
+
+  // log2 of the mean number of guesses, i.e. of the guessing entropy
+  auto log2GuessingEntropy() const noexcept -> double {
+    return log2GuessesSumExp_ - std::log2(static_cast<double>(count_));
+  }
+
+  // the mean of log2(rank + 1)
+  auto meanLog2Guesses() const noexcept -> double {
+    return log2GuessesSum_ / static_cast<double>(count_);
+  }
+
+  auto thresholdsBits() const noexcept -> std::vector<double> const & {
+    return thresholdsBits_;
+  }
+
+  auto successRate(std::size_t thresholdIndex) const -> double {
+    return static_cast<double>(successes_.at(thresholdIndex)) /
+           static_cast<double>(count_);
+  }
+
+private:
+  std::vector<double> thresholdsBits_;
+  std::vector<std::size_t> successes_;
+  std::size_t count_{0};
+  double log2GuessesSum_{0.0};
+  // log2 of the sum of 2^log2Guesses, as the ranks may not fit in a double
+  double log2GuessesSumExp_{-std::numeric_limits<double>::infinity()};
+
+  static auto logAdd2(double a, double b) noexcept -> double {
+    if (std::isinf(a) && a < 0.0) {
+      return b;
+    }
+    if (std::isinf(b) && b < 0.0) {
+      return a;
+    }
+    auto const high = std::max(a, b);
+    auto const low = std::min(a, b);
+    return high + std::log2(1.0 + std::exp2(low - high));
+  }
+};
+
+struct BatchOptions {
+  std::uint32_t precisionBits{16};
+  std::vector<double> thresholdsBits{};
+  std::size_t threadCount{0};
+};
+
+/**
+ * Ranks count experiments, each made on demand by makeExperiment(index) on
+ * the thread that ranks it, so that the tables never all exist at once.  Each
+ * thread keeps its own RankWorkspace and statistics, which are merged at the
+ * end.  Returns the statistics of every group, keyed by group.
+ */
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          typename MakeExperiment>
+auto rankBatch(std::size_t count, MakeExperiment &&makeExperiment,
+               BatchOptions const &options)
+    -> std::map<std::size_t, RankStatistics> {
+  auto const threadCount = resolveThreadCount(options.threadCount);
+  std::vector<RankWorkspace<RankType>> workspaces(threadCount);
+  std::vector<std::map<std::size_t, RankStatistics>> threadStatistics(
+      threadCount);
+
+  parallelFor(count, threadCount, [&](std::size_t index,
+                                      std::size_t threadIndex) {
+    decltype(auto) experiment = makeExperiment(index);
+    using ScoresType =
+        typename std::decay_t<decltype(experiment.scores)>::ScoresType;
+    auto const weights = mapToWeight<ScoresType, WeightType>(
+        experiment.scores, options.precisionBits);
+
+    auto const keyWeight = weights.weightForKey(experiment.key);
+    NullRankMonitor monitor;
+    auto const keyRank =
+        rank<RankType>(keyWeight, weights, workspaces[threadIndex], monitor);
+
+    auto &statistics = threadStatistics[threadIndex];
+    auto found = statistics.find(experiment.group);
+    if (found == std::end(statistics)) {
+      found = statistics
+                  .emplace(experiment.group,
+                           RankStatistics(options.thresholdsBits))
+                  .first;
+    }
+    RankType const guesses = keyRank + RankType{1};
+    found->second.add(approxLog2(guesses));
+  });
+
+  std::map<std::size_t, RankStatistics> merged;
+  for (auto const &statistics : threadStatistics) {
+    for (auto const &[group, groupStatistics] : statistics) {
+      auto found = merged.find(group);
+      if (found == std::end(merged)) {
+        merged.emplace(group, groupStatistics);
+      } else {
+        found->second.merge(groupStatistics);
+      }
+    }
+  }
+  return merged;
+}
+
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          typename ScoresType, class DimensionsType>
+auto rankBatch(
+    std::vector<Experiment<KeyLenBits, ScoresType, DimensionsType>> const
+        &experiments,
+    BatchOptions const &options) -> std::map<std::size_t, RankStatistics> {
+  return rankBatch<KeyLenBits, RankType, WeightType>(
+      experiments.size(),
+      [&experiments](std::size_t index) -> auto const & {
+        return experiments[index];
+      },
+      options);
+}
+
+} /* namespace rankcpp */
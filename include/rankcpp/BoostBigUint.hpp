@@ -1,9 +1,12 @@
 #pragma once
 
+#include <rankcpp/utils/Storable.hpp>
+
 #include <boost/multiprecision/cpp_dec_float.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include <cstdint>
+#include <type_traits>
 
 namespace rankcpp {
 
@@ -13,6 +16,10 @@ using BoostBigUint = typename boost::multiprecision::number<
         LengthBits, LengthBits, boost::multiprecision::unsigned_magnitude,
         boost::multiprecision::unchecked, void>>;
 
+// fixed-width, allocator-free cpp_ints keep their limbs inline
+template <std::uint32_t LengthBits>
+struct IsBitwiseStorable<BoostBigUint<LengthBits>> : std::true_type {};
+
 template <std::uint32_t Digits10>
 using BoostBigReal = typename boost::multiprecision::number<
     boost::multiprecision::cpp_dec_float<Digits10>>;
@@ -0,0 +1,416 @@
+#pragma once
+
+#include <rankcpp/Monitor.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/Hash.hpp>
+#include <rankcpp/utils/MappedFile.hpp>
+#include <rankcpp/utils/Storable.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/** \file
+ * \brief Rank DPs that save their progress and pick up where they left off
+ *
+ * Between distinguishing vectors the whole state of rank and rankAllWeights is
+ * the prev buffer and the number of vectors folded into it.  A checkpoint file
+ * holds those, in the native byte order:
+ *
+ * | offset | size | field                                       |
+ * |--------|------|---------------------------------------------|
+ * | 0      | 8    | magic, "RANKCKP" and a NUL                  |
+ * | 8      | 4    | format version                              |
+ * | 12     | 4    | 0x01020304                                  |
+ * | 16     | 4    | bytes per RankType                          |
+ * | 20     | 4    | reserved, 0                                 |
+ * | 24     | 8    | checkpointHash of the table and max weight  |
+ * | 32     | 8    | vectors completed                           |
+ * | 40     | 8    | entries in prev                             |
+ * | 48     | 8    | FNV-1a hash of prev                         |
+ * | 56     |      | prev                                        |
+ *
+ * Like MappedFile, this header is POSIX only.
+ */
+
+namespace rankcpp {
+
+/**
+ * When the checkpointed rank functions save their progress to path: after
+ * every everyVectors vectors and once every interval, where 0 turns either
+ * off.  A checkpoint is also saved when a monitor cancels the computation.
+ */
+struct CheckpointOptions {
+  std::string path;
+  std::size_t everyVectors{0};
+  std::chrono::duration<double> interval{std::chrono::minutes{5}};
+};
+
+template <typename RankType> struct Checkpoint {
+  std::uint64_t tableHash;
+  std::size_t vectorsCompleted;
+  std::vector<RankType> prev;
+};
+
+// identifies the DP a checkpoint belongs to
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType>
+auto checkpointHash(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights)
+    -> std::uint64_t {
+  Fnv1a hash;
+  hash.add(std::uint64_t{sizeof(RankType)});
+  hash.add(std::uint64_t{sizeof(WeightType)});
+  hash.add(static_cast<std::uint64_t>(maxWeight));
+  for (auto const &span : weights.dimensions().asSpans()) {
+    hash.add(span.start());
+    hash.add(span.count());
+  }
+  auto const &all = weights.allWeights();
+  hash.addBytes(all.data(), all.size() * sizeof(WeightType));
+  return hash.value();
+}
+
+namespace detail {
+
+constexpr std::array<char, 8> const CheckpointMagic = {'R', 'A', 'N', 'K',
+                                                       'C', 'K', 'P', '\0'};
+constexpr std::uint32_t const CheckpointVersion = 1;
+constexpr std::uint32_t const CheckpointByteOrder = 0x01020304;
+constexpr std::size_t const CheckpointHeaderBytes = 56;
+
+template <typename T> void writeValue(std::ostream &os, T const &value) {
+  os.write(reinterpret_cast<char const *>(&value), sizeof(value));
+}
+
+template <typename T>
+auto readValue(std::uint8_t const *data, std::size_t offset) -> T {
+  T value{};
+  std::memcpy(&value, data + offset, sizeof(value));
+  return value;
+}
+
+/**
+ * A temporary name next to path for one writer: the process id, a count of
+ * the names made by this process and a random suffix, against another host
+ * reusing the process id in a shared directory.
+ */
+inline auto partialPath(std::string const &path) -> std::string {
+  static std::atomic<std::uint64_t> counter{0};
+  return path + "." + std::to_string(::getpid()) + "-" +
+         std::to_string(counter++) + "-" +
+         std::to_string(std::random_device{}()) + ".partial";
+}
+
+/**
+ * Flushes the file or directory at path to disk.  A directory whose file
+ * system cannot sync directories (EINVAL) is left as it is.
+ */
+inline void syncToDisk(std::string const &path, bool directory) {
+  auto const flags = O_RDONLY | O_CLOEXEC | (directory ? O_DIRECTORY : 0);
+  auto const fd = ::open(path.c_str(), flags);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "cannot open " + path);
+  }
+  auto const result = ::fsync(fd);
+  auto const error = errno;
+  ::close(fd);
+  if (result != 0 && !(directory && error == EINVAL)) {
+    throw std::system_error(error, std::generic_category(),
+                            "cannot sync " + path);
+  }
+}
+
+} /* namespace detail */
+
+/**
+ * Writes checkpoint to a temporary file next to path and renames it over
+ * path, so that path always holds a complete checkpoint, even after a power
+ * failure: the file is synced before the rename and its directory after it.
+ * Each call writes
+ * its own temporary file, so any number of threads and processes can save to
+ * the same path and the last rename wins.
+ */
+template <typename RankType>
+void saveCheckpoint(std::string const &path,
+                    Checkpoint<RankType> const &checkpoint) {
+  static_assert(IsBitwiseStorableV<RankType>,
+                "RankType must be bitwise storable to checkpoint it");
+  auto const *const payload =
+      reinterpret_cast<char const *>(checkpoint.prev.data());
+  auto const payloadBytes = checkpoint.prev.size() * sizeof(RankType);
+  Fnv1a payloadHash;
+  payloadHash.addBytes(payload, payloadBytes);
+
+  auto const partialPath = detail::partialPath(path);
+  std::ofstream os(partialPath, std::ios::binary | std::ios::trunc);
+  os.write(detail::CheckpointMagic.data(), detail::CheckpointMagic.size());
+  detail::writeValue(os, detail::CheckpointVersion);
+  detail::writeValue(os, detail::CheckpointByteOrder);
+  detail::writeValue(os, static_cast<std::uint32_t>(sizeof(RankType)));
+  detail::writeValue(os, std::uint32_t{0});
+  detail::writeValue(os, checkpoint.tableHash);
+  detail::writeValue(os,
+                     static_cast<std::uint64_t>(checkpoint.vectorsCompleted));
+  detail::writeValue(os, static_cast<std::uint64_t>(checkpoint.prev.size()));
+  detail::writeValue(os, payloadHash.value());
+  os.write(payload, static_cast<std::streamsize>(payloadBytes));
+  os.close();
+  auto const discardPartial = [&partialPath] {
+    std::error_code ignored;
+    std::filesystem::remove(partialPath, ignored);
+  };
+  if (!os) {
+    discardPartial();
+    throw std::runtime_error("cannot write checkpoint " + partialPath);
+  }
+  try {
+    detail::syncToDisk(partialPath, false);
+  } catch (...) {
+    discardPartial();
+    throw;
+  }
+  std::filesystem::rename(partialPath, path);
+  auto const directory = std::filesystem::path(path).parent_path();
+  detail::syncToDisk(directory.empty() ? "." : directory.string(), true);
+}
+
+/**
+ * Reads the checkpoint at path, or returns nothing if there is none or it is
+ * not a complete checkpoint of this RankType.
+ */
+template <typename RankType>
+auto loadCheckpoint(std::string const &path)
+    -> std::optional<Checkpoint<RankType>> {
+  static_assert(IsBitwiseStorableV<RankType>,
+                "RankType must be bitwise storable to checkpoint it");
+  if (!std::filesystem::exists(path)) {
+    return std::nullopt;
+  }
+  MappedFile const file(path);
+  auto const *const data = file.asBytes().data();
+  if (file.size() < detail::CheckpointHeaderBytes ||
+      !std::equal(std::cbegin(detail::CheckpointMagic),
+                  std::cend(detail::CheckpointMagic),
+                  reinterpret_cast<char const *>(data)) ||
+      detail::readValue<std::uint32_t>(data, 8) !=
+          detail::CheckpointVersion ||
+      detail::readValue<std::uint32_t>(data, 12) !=
+          detail::CheckpointByteOrder ||
+      detail::readValue<std::uint32_t>(data, 16) != sizeof(RankType)) {
+    return std::nullopt;
+  }
+
+  auto const count = detail::readValue<std::uint64_t>(data, 40);
+  auto const payloadBytes = file.size() - detail::CheckpointHeaderBytes;
+  if (payloadBytes / sizeof(RankType) != count ||
+      payloadBytes % sizeof(RankType) != 0) {
+    return std::nullopt;
+  }
+  auto const *const payload = data + detail::CheckpointHeaderBytes;
+  Fnv1a payloadHash;
+  payloadHash.addBytes(payload, payloadBytes);
+  if (payloadHash.value() != detail::readValue<std::uint64_t>(data, 48)) {
+    return std::nullopt;
+  }
+
+  Checkpoint<RankType> checkpoint{
+      detail::readValue<std::uint64_t>(data, 24),
+      static_cast<std::size_t>(detail::readValue<std::uint64_t>(data, 32)),
+      std::vector<RankType>(static_cast<std::size_t>(count))};
+  std::memcpy(static_cast<void *>(checkpoint.prev.data()), payload,
+              payloadBytes);
+  return checkpoint;
+}
+
+namespace detail {
+
+/**
+ * Folds the distinguishing vectors from the last down to stopVector into
+ * state.prev, resuming after the state.vectorsCompleted already folded in and
+ * saving state as options ask.
+ */
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType, class MonitorType>
+void foldVectorsCheckpointed(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    std::size_t stopVector, CheckpointOptions const &options,
+    Checkpoint<RankType> &state, MonitorType &monitor) {
+  using Clock = std::chrono::steady_clock;
+  auto const &dims = weights.dimensions();
+  auto const weightCount = static_cast<std::size_t>(maxWeight);
+  std::vector<RankType> curr(weightCount, RankType{0});
+  auto &prev = state.prev;
+
+  auto lastSave = Clock::now();
+  std::size_t vectorsSinceSave = 0;
+  auto const save = [&] {
+    saveCheckpoint(options.path, state);
+    lastSave = Clock::now();
+    vectorsSinceSave = 0;
+  };
+
+  for (auto vi = dims.vectorCount() - state.vectorsCompleted;
+       vi-- > stopVector;) {
+    for (std::size_t ski = 0; ski < dims.subkeyCount(vi); ++ski) {
+      auto const weight = static_cast<std::size_t>(weights(vi, ski));
+      if (weight >= weightCount) {
+        continue;
+      }
+      auto const currEnd = weightCount - weight;
+      detail::addRanks(curr.data(), prev.data() + weight, currEnd);
+      if constexpr (MonitorType::enabled) {
+        monitor.addOperations(currEnd, 3 * currEnd * sizeof(RankType));
+      }
+    }
+    std::swap(curr, prev);
+    std::fill(std::begin(curr), std::end(curr), RankType{0});
+    ++state.vectorsCompleted;
+    ++vectorsSinceSave;
+
+    if ((options.everyVectors != 0 &&
+         vectorsSinceSave >= options.everyVectors) ||
+        (options.interval.count() > 0 &&
+         Clock::now() - lastSave >= options.interval)) {
+      save();
+    }
+    try {
+      monitor.vectorCompleted();
+    } catch (RankCancelled const &) {
+      if (vectorsSinceSave != 0) {
+        save();
+      }
+      throw;
+    }
+  }
+}
+
+// the checkpoint at options.path if it belongs to this DP, or a fresh start
+template <typename RankType>
+auto resumeOrStart(CheckpointOptions const &options, std::uint64_t tableHash,
+                   std::size_t weightCount, std::size_t maxVectors)
+    -> Checkpoint<RankType> {
+  auto checkpoint = loadCheckpoint<RankType>(options.path);
+  if (checkpoint && checkpoint->tableHash == tableHash &&
+      checkpoint->prev.size() == weightCount &&
+      checkpoint->vectorsCompleted <= maxVectors) {
+    return std::move(*checkpoint);
+  }
+  return {tableHash, 0, std::vector<RankType>(weightCount, RankType{1})};
+}
+
+} /* namespace detail */
+
+/**
+ * rank, checkpointing to options.path as it goes.  If that file holds a
+ * checkpoint of the same table and max weight the DP resumes from it, and it
+ * is removed once the rank is known.  The monitor is started with the number
+ * of vectors left to fold.
+ */
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType, class MonitorType>
+auto rankCheckpointed(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    CheckpointOptions const &options, MonitorType &monitor) -> RankType {
+  if (maxWeight == 0) {
+    throw std::invalid_argument("The weight to rank to must be > 0");
+  }
+
+  auto const &dims = weights.dimensions();
+  auto state = detail::resumeOrStart<RankType>(
+      options, checkpointHash<RankType>(maxWeight, weights), maxWeight,
+      dims.vectorCount() - 1);
+  monitor.start(dims.vectorCount() - state.vectorsCompleted);
+  detail::foldVectorsCheckpointed(maxWeight, weights, 1, options, state,
+                                  monitor);
+
+  // only weight 0 is needed from the first vector
+  RankType result{0};
+  for (std::size_t ski = 0; ski < dims.subkeyCount(0); ++ski) {
+    auto const weight = weights(0, ski);
+    if (weight < maxWeight) {
+      result += state.prev[weight];
+    }
+  }
+  if constexpr (MonitorType::enabled) {
+    auto const subkeyCount = dims.subkeyCount(0);
+    monitor.addOperations(subkeyCount, 2 * subkeyCount * sizeof(RankType));
+  }
+  monitor.vectorCompleted();
+
+  std::error_code ignored;
+  std::filesystem::remove(options.path, ignored);
+  return result;
+}
+
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType>
+auto rankCheckpointed(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    CheckpointOptions const &options) -> RankType {
+  NullRankMonitor monitor;
+  return rankCheckpointed<RankType, WeightType, DimensionsType>(
+      maxWeight, weights, options, monitor);
+}
+
+// rankAllWeights, checkpointing and resuming as rankCheckpointed does
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType, class MonitorType>
+auto rankAllWeightsCheckpointed(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    CheckpointOptions const &options, MonitorType &monitor)
+    -> std::vector<RankType> {
+  if (maxWeight == 0) {
+    throw std::invalid_argument("The max weight ranked up to must > 0");
+  }
+
+  auto const &dims = weights.dimensions();
+  auto state = detail::resumeOrStart<RankType>(
+      options, checkpointHash<RankType>(maxWeight, weights), maxWeight,
+      dims.vectorCount());
+  monitor.start(dims.vectorCount() - state.vectorsCompleted);
+  detail::foldVectorsCheckpointed(maxWeight, weights, 0, options, state,
+                                  monitor);
+
+  std::error_code ignored;
+  std::filesystem::remove(options.path, ignored);
+  std::reverse(std::begin(state.prev), std::end(state.prev));
+  return std::move(state.prev);
+}
+
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType>
+auto rankAllWeightsCheckpointed(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    CheckpointOptions const &options) -> std::vector<RankType> {
+  NullRankMonitor monitor;
+  return rankAllWeightsCheckpointed<RankType, WeightType, DimensionsType>(
+      maxWeight, weights, options, monitor);
+}
+
+} /* namespace rankcpp */
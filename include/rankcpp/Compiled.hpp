@@ -0,0 +1,75 @@
+#pragma once
+
+#ifndef RANKCPP_COMPILED
+#error "rankcpp/Compiled.hpp needs the rankcpp_compiled library"
+#endif
+
+#include <rankcpp/BoostBigUint.hpp>
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Monitor.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/ScoresTable.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/** \file
+ * \brief The instantiations built once into rankcpp_compiled
+ *
+ * Including this header instead of Rank.hpp declares the rank functions and
+ * mapToWeight for the usual RankType and WeightType pairs over Dimensions as
+ * extern templates, so a translation unit that uses only those never compiles
+ * their bodies.  Linking rankcpp_compiled also defines RANKCPP_COMPILED, which
+ * swaps the std::uint64_t inner loop of every rank DP for one built for SSE4.2,
+ * AVX2 and AVX-512 and chosen for the CPU at load time.
+ */
+
+// the (RankType, WeightType) pairs built into rankcpp_compiled
+#define RANKCPP_COMPILED_TYPES(X)                                              \
+  X(std::uint64_t, std::uint32_t)                                              \
+  X(std::uint64_t, std::uint64_t)                                              \
+  X(::rankcpp::BoostBigUint<128>, std::uint32_t)                               \
+  X(::rankcpp::BoostBigUint<128>, std::uint64_t)                               \
+  X(::rankcpp::BoostBigUint<256>, std::uint32_t)                               \
+  X(::rankcpp::BoostBigUint<256>, std::uint64_t)
+
+// Prefix is "template" to instantiate the functions, or "extern template" to
+// declare that they are instantiated elsewhere
+#define RANKCPP_RANK_INSTANTIATIONS(Prefix, RankType, WeightType)             \
+  Prefix auto rank<RankType, WeightType, Dimensions,                         \
+                   std::vector<WeightType>, NullRankMonitor>(                 \
+      WeightType, WeightTable<WeightType> const &, RankWorkspace<RankType> &, \
+      NullRankMonitor &)                                                      \
+      ->RankType;                                                             \
+  Prefix auto rank<RankType, WeightType, Dimensions,                         \
+                   std::vector<WeightType>>(WeightType,                       \
+                                            WeightTable<WeightType> const &)  \
+      ->RankType;                                                             \
+  Prefix auto rankLowMem<RankType, WeightType, Dimensions,                   \
+                         std::vector<WeightType>>(                            \
+      WeightType, WeightTable<WeightType> const &)                            \
+      ->RankType;                                                             \
+  Prefix auto rankAllWeights<RankType, WeightType, Dimensions,               \
+                             std::vector<WeightType>>(                        \
+      WeightType, WeightTable<WeightType> const &)                            \
+      ->std::vector<RankType>;
+
+#define RANKCPP_MAP_INSTANTIATIONS(Prefix, WeightType)                        \
+  Prefix auto mapToWeight<double, WeightType, Dimensions,                    \
+                          std::vector<double>>(ScoresTable<double> const &,   \
+                                               std::uint32_t)                 \
+      ->WeightTable<WeightType>;
+
+#define RANKCPP_EXTERN_RANK(RankType, WeightType)                             \
+  RANKCPP_RANK_INSTANTIATIONS(extern template, RankType, WeightType)
+
+namespace rankcpp {
+
+RANKCPP_COMPILED_TYPES(RANKCPP_EXTERN_RANK)
+RANKCPP_MAP_INSTANTIATIONS(extern template, std::uint32_t)
+RANKCPP_MAP_INSTANTIATIONS(extern template, std::uint64_t)
+
+} /* namespace rankcpp */
+
+#undef RANKCPP_EXTERN_RANK
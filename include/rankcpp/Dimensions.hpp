@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <initializer_list>
 #include <numeric>
+#include <type_traits>
 #include <vector>
 
 namespace rankcpp {
@@ -28,6 +29,10 @@ public:
     initFromIter(std::cbegin(vectorWidthsBits), std::cend(vectorWidthsBits));
   }
 
+  explicit Dimensions(std::vector<std::uint32_t> const &vectorWidthsBits) {
+    initFromIter(std::cbegin(vectorWidthsBits), std::cend(vectorWidthsBits));
+  }
+
   Dimensions(std::size_t vectorCount, std::size_t vectorWidthsBits) noexcept {
     for (auto vectorIndex : ranges::views::iota(std::size_t{0}, vectorCount)) {
       auto const offset = vectorIndex * vectorWidthsBits;
@@ -122,6 +127,9 @@ private:
 template <std::uint32_t VectorCount, std::uint32_t VectorWidthBits>
 class FixedDimensions {
 public:
+  static constexpr std::uint32_t const FixedVectorCount = VectorCount;
+  static constexpr std::uint32_t const FixedVectorWidthBits = VectorWidthBits;
+
   constexpr FixedDimensions() noexcept {
     // TODOcpp20 for a constexpr std::generate
     for (std::uint32_t vi = 0; vi < VectorCount; vi++) {
@@ -190,4 +198,15 @@ private:
   std::array<BitSpan, VectorCount> spans{};
 };
 
+// whether a dimensions type has its shape fixed at compile time
+template <class DimensionsType> struct IsFixedDimensions : std::false_type {};
+
+template <std::uint32_t VectorCount, std::uint32_t VectorWidthBits>
+struct IsFixedDimensions<FixedDimensions<VectorCount, VectorWidthBits>>
+    : std::true_type {};
+
+template <class DimensionsType>
+constexpr bool const IsFixedDimensionsV =
+    IsFixedDimensions<DimensionsType>::value;
+
 } /* namespace rankcpp */
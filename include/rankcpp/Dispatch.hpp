@@ -0,0 +1,113 @@
+#pragma once
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <gsl/span>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/** \file
+ * \brief Running tables of common runtime shapes through FixedDimensions code
+ *
+ * Dimensions read at runtime almost always have one of a few equal-width
+ * shapes.  The functions here check for those shapes and, on a match, view
+ * the table's weights as a table over the matching FixedDimensions, so that
+ * keys are read at compile-time bit positions without a copy of the weights.
+ * Any other shape takes the generic path.
+ */
+
+namespace rankcpp {
+
+template <class... Shapes> struct ShapeList {};
+
+// 16x8 and 32x8 cover AES-128 and AES-256 by byte, 32x4 and 8x16 AES-128 by
+// nibble and by 16-bit word
+using DispatchedShapes =
+    ShapeList<FixedDimensions<16, 8>, FixedDimensions<32, 8>,
+              FixedDimensions<32, 4>, FixedDimensions<8, 16>>;
+
+template <class FixedDimensionsType>
+auto hasShape(Dimensions const &dims) noexcept -> bool {
+  constexpr FixedDimensionsType const shape;
+  auto const &spans = dims.asSpans();
+  auto const &fixedSpans = shape.asSpans();
+  return spans.size() == fixedSpans.size() &&
+         std::equal(std::cbegin(spans), std::cend(spans),
+                    std::cbegin(fixedSpans));
+}
+
+/**
+ * Calls f with the FixedDimensions in Shapes that dims has the shape of, or
+ * with dims itself if it has none of them.  f must return the same type
+ * either way.
+ */
+template <typename Function, class Shape, class... Shapes>
+auto withFixedShape(Dimensions const &dims, Function &&f,
+                    ShapeList<Shape, Shapes...> /*unused*/)
+    -> decltype(f(dims)) {
+  if (hasShape<Shape>(dims)) {
+    return f(Shape{});
+  }
+  if constexpr (sizeof...(Shapes) > 0) {
+    return withFixedShape(dims, f, ShapeList<Shapes...>{});
+  } else {
+    return f(dims);
+  }
+}
+
+template <typename Function>
+auto withFixedShape(Dimensions const &dims, Function &&f)
+    -> decltype(f(dims)) {
+  return withFixedShape(dims, f, DispatchedShapes{});
+}
+
+namespace detail {
+
+/**
+ * Calls f with a view of table's weights over the FixedDimensions it has the
+ * shape of, or with table itself.
+ */
+template <typename WeightType, class StorageType, typename Function>
+auto withFixedTable(
+    WeightTable<WeightType, Dimensions, StorageType> const &table,
+    Function &&f) {
+  return withFixedShape(table.dimensions(), [&](auto const &shape) {
+    using ShapeType = std::decay_t<decltype(shape)>;
+    if constexpr (IsFixedDimensionsV<ShapeType>) {
+      auto const &weights = table.allWeights();
+      return f(ConstWeightTableView<WeightType, ShapeType>(
+          shape, gsl::span<WeightType const>(weights.data(), weights.size())));
+    } else {
+      return f(table);
+    }
+  });
+}
+
+} /* namespace detail */
+
+// weightForKey, reading the subkeys at compile-time positions if it can
+template <std::uint32_t KeyLenBits, typename WeightType, class StorageType>
+auto weightForKeyDispatched(
+    WeightTable<WeightType, Dimensions, StorageType> const &weights,
+    Key<KeyLenBits> const &key) -> WeightType {
+  return detail::withFixedTable(weights, [&](auto const &table) {
+    return table.weightForKey(key);
+  });
+}
+
+template <std::uint32_t KeyLenBits, typename WeightType, class StorageType>
+void weightsForKeysDispatched(
+    WeightTable<WeightType, Dimensions, StorageType> const &weights,
+    gsl::span<Key<KeyLenBits> const> keys, gsl::span<WeightType> keyWeights,
+    std::size_t threadCount = 0) {
+  detail::withFixedTable(weights, [&](auto const &table) {
+    table.weightsForKeys(keys, keyWeights, threadCount);
+  });
+}
+
+} /* namespace rankcpp */
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <rankcpp/Key.hpp>
+#include <rankcpp/Unrank.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+/** \file
+ * \brief Enumerating the keys below a weight depth first
+ *
+ * The keys with a weight below counts.maxWeight() are walked depth first,
+ * trying the subkeys of each vector lightest first.  The suffix counts say
+ * how many keys lie under any partial key, so a subkey is only entered if it
+ * completes at least one key and the first that does not ends its vector.
+ * Each key costs O(vectorCount) amortised, and beyond the counts the walk
+ * keeps only the sorted subkeys and one position per vector, however many
+ * keys it visits.
+ *
+ * Keys are numbered in the order they are visited, which is not the rank
+ * order used by unrank, and any range of them can be walked on its own: the
+ * walk starts by skipping whole subtrees before the first.
+ */
+
+namespace rankcpp {
+
+namespace detail {
+
+struct AcceptAll {
+  template <typename KeyType>
+  constexpr auto operator()(std::size_t /*unused*/,
+                            KeyType const & /*unused*/) const noexcept
+      -> bool {
+    return true;
+  }
+};
+
+} /* namespace detail */
+
+/**
+ * Calls visit(key) for each key numbered from first up to but excluding last
+ * (or counts.keyCount(), if smaller); returning false from visit ends the
+ * walk.  counts must have been built from weights.  Returns the number of
+ * keys visited.
+ *
+ * accept(depth, key) is called each time the subkey of vector depth is fixed,
+ * when only the subkeys of vectors 0 to depth in key are meaningful.
+ * Returning false skips every key that starts with those subkeys, so a check
+ * on a few key bytes can reject whole subtrees before they are walked.  The
+ * skipped keys still take up their numbers in the range.
+ */
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          class DimensionsType, class StorageType, typename Visitor,
+          typename Predicate>
+auto enumerateKeys(
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    SuffixCounts<RankType> const &counts, RankType const &first,
+    RankType last, Visitor &&visit, Predicate &&accept) -> RankType {
+  auto const &dims = weights.dimensions();
+  if (dims.keyLengthBits() > KeyLenBits) {
+    throw std::invalid_argument("The key is shorter than the dimensions");
+  }
+  if (dims.vectorCount() != counts.vectorCount()) {
+    throw std::invalid_argument("The counts are for a different table");
+  }
+  last = std::min(last, counts.keyCount());
+  if (!(first < last)) {
+    return RankType{0};
+  }
+
+  auto const vectorCount = dims.vectorCount();
+  auto const &spans = dims.asSpans();
+  std::vector<std::vector<std::size_t>> order(vectorCount);
+  for (std::size_t vi = 0; vi < vectorCount; ++vi) {
+    order[vi].resize(dims.subkeyCount(vi));
+    std::iota(std::begin(order[vi]), std::end(order[vi]), std::size_t{0});
+    std::stable_sort(std::begin(order[vi]), std::end(order[vi]),
+                     [&](std::size_t a, std::size_t b) {
+                       return weights(vi, a) < weights(vi, b);
+                     });
+  }
+
+  // budget[vi] bounds the weight of vectors vi onwards; position[vi] is the
+  // place in order[vi] of the subkey chosen for vi
+  std::vector<std::size_t> budget(vectorCount + 1);
+  std::vector<std::size_t> position(vectorCount);
+  budget[0] = counts.maxWeight();
+  Key<KeyLenBits> key{};
+
+  // the number of keys under subkey order[vi][pi], 0 past the last that fits
+  auto const keysUnder = [&](std::size_t vi, std::size_t pi) -> RankType {
+    if (pi >= order[vi].size()) {
+      return RankType{0};
+    }
+    auto const weight = static_cast<std::size_t>(weights(vi, order[vi][pi]));
+    return weight < budget[vi] ? counts.below(vi + 1, budget[vi] - weight)
+                               : RankType{0};
+  };
+  auto const choose = [&](std::size_t vi, std::size_t pi) {
+    auto const subkey = order[vi][pi];
+    position[vi] = pi;
+    budget[vi + 1] = budget[vi] - static_cast<std::size_t>(weights(vi, subkey));
+    key.setSubkeyValue(spans[vi], subkey);
+  };
+
+  // pi is the next subkey to try at depth; skip counts the keys still to
+  // pass over before first, and remaining those left up to last
+  std::size_t depth = 0;
+  std::size_t pi = 0;
+  auto skip = first;
+  auto remaining = last - first;
+  RankType visited{0};
+  while (true) {
+    auto const block = keysUnder(depth, pi);
+    if (block == RankType{0}) {
+      // the later subkeys of this vector are heavier still
+      if (depth == 0) {
+        return visited;
+      }
+      --depth;
+      pi = position[depth] + 1;
+      continue;
+    }
+    if (!(skip < block)) {
+      skip -= block;
+      ++pi;
+      continue;
+    }
+
+    choose(depth, pi);
+    if (!accept(depth, static_cast<Key<KeyLenBits> const &>(key))) {
+      auto const dropped = block - skip;
+      if (!(dropped < remaining)) {
+        return visited;
+      }
+      skip = RankType{0};
+      remaining -= dropped;
+      ++pi;
+      continue;
+    }
+    if (depth + 1 < vectorCount) {
+      ++depth;
+      pi = 0;
+      continue;
+    }
+
+    ++visited;
+    remaining -= RankType{1};
+    if (!visit(static_cast<Key<KeyLenBits> const &>(key)) ||
+        remaining == RankType{0}) {
+      return visited;
+    }
+    ++pi;
+  }
+}
+
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          class DimensionsType, class StorageType, typename Visitor>
+auto enumerateKeys(
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    SuffixCounts<RankType> const &counts, RankType const &first,
+    RankType const &last, Visitor &&visit) -> RankType {
+  return enumerateKeys<KeyLenBits>(weights, counts, first, last, visit,
+                                   detail::AcceptAll{});
+}
+
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          class DimensionsType, class StorageType, typename Visitor>
+auto enumerateKeys(
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    SuffixCounts<RankType> const &counts, Visitor &&visit) -> RankType {
+  return enumerateKeys<KeyLenBits>(weights, counts, RankType{0},
+                                   counts.keyCount(), visit);
+}
+
+} /* namespace rankcpp */
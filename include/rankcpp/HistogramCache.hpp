@@ -0,0 +1,256 @@
+#pragma once
+
+#include <rankcpp/Checkpoint.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/Encoding.hpp>
+#include <rankcpp/utils/Hash.hpp>
+
+#include <gsl/span>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** \file
+ * \brief Reusing partial rank DPs across runs through an on-disk cache
+ *
+ * Entries are checkpoints, so like Checkpoint.hpp this is POSIX only.
+ */
+
+namespace rankcpp {
+
+/**
+ * A directory of DP buffers named by a hash of everything they were computed
+ * from, so a buffer can be shared by any table it applies to and is never
+ * stale.  Entries are checkpoint files (see Checkpoint.hpp); one that does not
+ * read back whole is treated as missing.
+ */
+class HistogramCache {
+public:
+  explicit HistogramCache(std::string directory)
+      : directory_(std::move(directory)) {
+    std::filesystem::create_directories(directory_);
+  }
+
+  auto directory() const noexcept -> std::string const & { return directory_; }
+
+  auto path(std::uint64_t key) const -> std::string {
+    // big-endian, so the name reads as the key in hex
+    std::array<std::uint8_t, 8> bytes{};
+    for (std::size_t b = 0; b < bytes.size(); ++b) {
+      bytes[b] = static_cast<std::uint8_t>(key >> (56 - 8 * b));
+    }
+    std::array<char, 16> name{};
+    bytesToHex(bytes, name);
+    auto const file = std::string(name.data(), name.size()) + ".dp";
+    return (std::filesystem::path(directory_) / file).string();
+  }
+
+  auto contains(std::uint64_t key) const -> bool {
+    return std::filesystem::exists(path(key));
+  }
+
+  template <typename RankType>
+  auto load(std::uint64_t key, std::size_t length) const
+      -> std::optional<std::vector<RankType>> {
+    auto entry = loadCheckpoint<RankType>(path(key));
+    if (!entry || entry->tableHash != key || entry->prev.size() != length) {
+      return std::nullopt;
+    }
+    return std::move(entry->prev);
+  }
+
+  template <typename RankType>
+  void store(std::uint64_t key, std::vector<RankType> buffer) const {
+    saveCheckpoint(path(key), Checkpoint<RankType>{key, 0, std::move(buffer)});
+  }
+
+private:
+  std::string directory_;
+};
+
+namespace detail {
+
+template <class WeightTableType>
+void hashVector(Fnv1a &hash, WeightTableType const &weights,
+                std::size_t vectorIndex) {
+  auto const &dims = weights.dimensions();
+  auto const *const first =
+      weights.allWeights().data() + dims.scoresBeforeCount(vectorIndex);
+  hash.add(dims.vectorWidthBits(vectorIndex));
+  hash.addBytes(first, dims.subkeyCount(vectorIndex) * sizeof(*first));
+}
+
+// suffix[c] becomes the number of keys over vector vectorIndex and the vectors
+// already folded into suffix with a weight below maxWeight - c
+template <typename RankType, class WeightTableType>
+void foldSuffix(WeightTableType const &weights, std::size_t vectorIndex,
+                std::vector<RankType> &suffix, std::vector<RankType> &scratch) {
+  auto const weightCount = suffix.size();
+  std::fill(std::begin(scratch), std::end(scratch), RankType{0});
+  for (std::size_t ski = 0;
+       ski < weights.dimensions().subkeyCount(vectorIndex); ++ski) {
+    auto const weight = static_cast<std::size_t>(weights(vectorIndex, ski));
+    if (weight < weightCount) {
+      addRanks(scratch.data(), suffix.data() + weight, weightCount - weight);
+    }
+  }
+  std::swap(suffix, scratch);
+}
+
+// prefix[w] becomes the number of keys over the vectors already extended into
+// prefix and vector vectorIndex with a weight of exactly w
+template <typename RankType, class WeightTableType>
+void extendPrefix(WeightTableType const &weights, std::size_t vectorIndex,
+                  std::vector<RankType> &prefix,
+                  std::vector<RankType> &scratch) {
+  auto const weightCount = prefix.size();
+  std::fill(std::begin(scratch), std::end(scratch), RankType{0});
+  for (std::size_t ski = 0;
+       ski < weights.dimensions().subkeyCount(vectorIndex); ++ski) {
+    auto const weight = static_cast<std::size_t>(weights(vectorIndex, ski));
+    if (weight < weightCount) {
+      addRanks(scratch.data() + weight, prefix.data(), weightCount - weight);
+    }
+  }
+  std::swap(prefix, scratch);
+}
+
+} /* namespace detail */
+
+/**
+ * rank, reusing the DPs of earlier calls through cache.  The vectors are cut
+ * into groups of groupSize, and at each cut the cache keeps the histogram of
+ * key weights over the vectors before it and the DP buffer over the vectors
+ * after it, each keyed by a hash of the widths and weights of those vectors
+ * and maxWeight.  The rank is the sum over w of prefix[w] * suffix[w] at any
+ * cut, so only the vectors between the nearest cached cuts either side of the
+ * changes since an earlier call are folded in.  The prefix is extended and
+ * the suffix folded towards the middle of that stretch, caching both as they
+ * go, so the first call costs no more than rank.
+ */
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType>
+auto rankCached(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    HistogramCache const &cache, std::size_t groupSize = 4) -> RankType {
+  if (maxWeight == 0) {
+    throw std::invalid_argument("The weight to rank to must be > 0");
+  }
+  if (groupSize == 0) {
+    throw std::invalid_argument("The group size must be > 0");
+  }
+
+  auto const &dims = weights.dimensions();
+  auto const vectorCount = dims.vectorCount();
+  auto const weightCount = static_cast<std::size_t>(maxWeight);
+
+  std::vector<std::size_t> cuts;
+  for (std::size_t vi = 0; vi < vectorCount; vi += groupSize) {
+    cuts.push_back(vi);
+  }
+  cuts.push_back(vectorCount);
+  auto const last = cuts.size() - 1;
+
+  auto const startHash = [&](char tag) {
+    Fnv1a hash;
+    hash.add(tag);
+    hash.add(std::uint64_t{sizeof(RankType)});
+    hash.add(std::uint64_t{sizeof(WeightType)});
+    hash.add(static_cast<std::uint64_t>(maxWeight));
+    return hash;
+  };
+  std::vector<std::uint64_t> prefixKeys(cuts.size());
+  std::vector<std::uint64_t> suffixKeys(cuts.size());
+  auto prefixHash = startHash('P');
+  for (std::size_t i = 0; i < cuts.size(); ++i) {
+    for (auto vi = i == 0 ? 0 : cuts[i - 1]; vi < cuts[i]; ++vi) {
+      detail::hashVector(prefixHash, weights, vi);
+    }
+    prefixKeys[i] = prefixHash.value();
+  }
+  auto suffixHash = startHash('S');
+  for (auto i = cuts.size(); i-- > 0;) {
+    for (auto vi = i == last ? vectorCount : cuts[i + 1]; vi-- > cuts[i];) {
+      detail::hashVector(suffixHash, weights, vi);
+    }
+    suffixKeys[i] = suffixHash.value();
+  }
+
+  // the nearest pair of cuts with a cached prefix and suffix; the empty
+  // prefix and suffix at either end need no cache
+  std::vector<bool> havePrefix(cuts.size());
+  std::vector<bool> haveSuffix(cuts.size());
+  for (std::size_t i = 0; i < cuts.size(); ++i) {
+    havePrefix[i] = i == 0 || cache.contains(prefixKeys[i]);
+    haveSuffix[i] = i == last || cache.contains(suffixKeys[i]);
+  }
+  std::vector<RankType> prefix;
+  std::vector<RankType> suffix;
+  std::size_t from = 0;
+  std::size_t to = last;
+  while (true) {
+    from = 0;
+    to = last;
+    for (std::size_t i = 0; i < cuts.size(); ++i) {
+      for (auto j = i; j < cuts.size() && havePrefix[i]; ++j) {
+        if (haveSuffix[j] && cuts[j] - cuts[i] < cuts[to] - cuts[from]) {
+          from = i;
+          to = j;
+        }
+      }
+    }
+
+    if (from == 0) {
+      prefix.assign(weightCount, RankType{0});
+      prefix[0] = RankType{1};
+    } else if (auto cached =
+                   cache.load<RankType>(prefixKeys[from], weightCount)) {
+      prefix = std::move(*cached);
+    } else {
+      havePrefix[from] = false;
+      continue;
+    }
+    if (to == last) {
+      suffix.assign(weightCount, RankType{1});
+    } else if (auto cached =
+                   cache.load<RankType>(suffixKeys[to], weightCount)) {
+      suffix = std::move(*cached);
+    } else {
+      haveSuffix[to] = false;
+      continue;
+    }
+    break;
+  }
+
+  std::vector<RankType> scratch(weightCount);
+  auto const middle = (from + to) / 2;
+  for (auto i = from; i < middle; ++i) {
+    for (auto vi = cuts[i]; vi < cuts[i + 1]; ++vi) {
+      detail::extendPrefix(weights, vi, prefix, scratch);
+    }
+    cache.store(prefixKeys[i + 1], prefix);
+  }
+  for (auto i = to; i > middle; --i) {
+    for (auto vi = cuts[i]; vi-- > cuts[i - 1];) {
+      detail::foldSuffix(weights, vi, suffix, scratch);
+    }
+    cache.store(suffixKeys[i - 1], suffix);
+  }
+
+  RankType result{0};
+  for (std::size_t w = 0; w < weightCount; ++w) {
+    result += prefix[w] * suffix[w];
+  }
+  return result;
+}
+
+} /* namespace rankcpp */
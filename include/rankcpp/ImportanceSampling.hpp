@@ -0,0 +1,219 @@
+#pragma once
+
+#include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/Parallel.hpp>
+#include <rankcpp/utils/Random.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+/** \file
+ * \brief Estimating rank by importance sampling, without a DP
+ *
+ * Keys are drawn from the table tilted towards the weight being ranked to:
+ * subkey s of vector v with probability exp(-lambda * w(v, s)) / Z_v, with
+ * lambda chosen so that the expected key weight is maxWeight.  Each key
+ * lighter than maxWeight then stands for 1 / q(key) keys, so the mean of
+ * exp(lambda * (w(key) - maxWeight)) over the draws, scaled by
+ * exp(lambda * maxWeight) * prod Z_v, is an unbiased estimate of the rank.
+ * The cost is independent of the size of the weights, and a draw costs one
+ * binary search per vector.
+ */
+
+namespace rankcpp {
+
+/**
+ * sampleCount draws, taken in blocks of 4096 each from its own Xoshiro256
+ * seeded from seed, so the estimate depends only on the seed and not on the
+ * thread count (0 uses every hardware thread).  The interval is the normal
+ * approximation at z standard errors.
+ */
+struct ImportanceSamplingOptions {
+  std::size_t sampleCount{std::size_t{1} << 20U};
+  std::uint64_t seed{0};
+  std::size_t threadCount{0};
+  double z{1.96};
+};
+
+/**
+ * log2 of the estimated rank and of the ends of its confidence interval.
+ * hits is the number of draws lighter than maxWeight.  A bound (or, with no
+ * hits, the estimate) at a rank of zero is -infinity.
+ */
+struct SampledRank {
+  double log2Rank;
+  double log2Lower;
+  double log2Upper;
+  std::size_t sampleCount;
+  std::size_t hits;
+};
+
+namespace detail {
+
+/**
+ * The tilted distribution of each vector: cdf holds the running sums of
+ * exp(-lambda * (w - min_v)) for each vector in turn, and log2Z the sum over
+ * the vectors of log2 Z_v.
+ */
+struct TiltedTable {
+  double lambda{0};
+  double log2Z{0};
+  std::vector<double> cdf;
+};
+
+template <class WeightTableType>
+auto tiltedMeanWeight(WeightTableType const &weights, double lambda)
+    -> double {
+  auto const &dims = weights.dimensions();
+  double mean = 0;
+  for (std::size_t vi = 0; vi < dims.vectorCount(); ++vi) {
+    auto minWeight = std::numeric_limits<double>::infinity();
+    for (std::size_t ski = 0; ski < dims.subkeyCount(vi); ++ski) {
+      minWeight = std::min(minWeight, static_cast<double>(weights(vi, ski)));
+    }
+    double z = 0;
+    double sum = 0;
+    for (std::size_t ski = 0; ski < dims.subkeyCount(vi); ++ski) {
+      auto const weight = static_cast<double>(weights(vi, ski));
+      auto const p = std::exp(-lambda * (weight - minWeight));
+      z += p;
+      sum += p * weight;
+    }
+    mean += sum / z;
+  }
+  return mean;
+}
+
+// the lambda >= 0 at which the tilted mean key weight is target
+template <class WeightTableType>
+auto tiltFor(WeightTableType const &weights, double target) -> double {
+  if (tiltedMeanWeight(weights, 0) <= target) {
+    return 0;
+  }
+  double low = 0;
+  double high = 1;
+  for (int i = 0; i < 64 && tiltedMeanWeight(weights, high) > target; ++i) {
+    low = high;
+    high *= 2;
+  }
+  for (int i = 0; i < 64; ++i) {
+    auto const middle = (low + high) / 2;
+    if (tiltedMeanWeight(weights, middle) > target) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return high;
+}
+
+template <class WeightTableType>
+auto tiltedTable(WeightTableType const &weights, double lambda)
+    -> TiltedTable {
+  auto const &dims = weights.dimensions();
+  TiltedTable table;
+  table.lambda = lambda;
+  table.cdf.resize(dims.scoresCount());
+  for (std::size_t vi = 0; vi < dims.vectorCount(); ++vi) {
+    auto minWeight = std::numeric_limits<double>::infinity();
+    for (std::size_t ski = 0; ski < dims.subkeyCount(vi); ++ski) {
+      minWeight = std::min(minWeight, static_cast<double>(weights(vi, ski)));
+    }
+    auto *const cdf = table.cdf.data() + dims.scoresBeforeCount(vi);
+    double z = 0;
+    for (std::size_t ski = 0; ski < dims.subkeyCount(vi); ++ski) {
+      auto const weight = static_cast<double>(weights(vi, ski));
+      z += std::exp(-lambda * (weight - minWeight));
+      cdf[ski] = z;
+    }
+    table.log2Z += std::log2(z) - lambda * minWeight / std::log(2.0);
+  }
+  return table;
+}
+
+} /* namespace detail */
+
+/**
+ * An estimate of the number of keys with a weight below maxWeight, for
+ * tables too large for rank or even rankBounds.  The interval is only as good
+ * as the normal approximation: with few hits it is too narrow, so check hits.
+ */
+template <typename WeightType, class DimensionsType, class StorageType>
+auto rankImportanceSampled(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    ImportanceSamplingOptions const &options = {}) -> SampledRank {
+  if (options.sampleCount == 0) {
+    throw std::invalid_argument("Need at least one sample");
+  }
+
+  auto const &dims = weights.dimensions();
+  auto const target = static_cast<double>(maxWeight);
+  auto const lambda = detail::tiltFor(weights, target);
+  auto const tilted = detail::tiltedTable(weights, lambda);
+
+  struct BlockSums {
+    double sum{0};
+    double sumSquares{0};
+    std::size_t hits{0};
+  };
+  std::size_t const blockSize = 4096;
+  auto const blockCount = (options.sampleCount + blockSize - 1) / blockSize;
+  std::vector<BlockSums> blocks(blockCount);
+  parallelFor(
+      blockCount, options.threadCount,
+      [&](std::size_t blockIndex, std::size_t /*unused*/) {
+        Xoshiro256 rng(deriveSeed(options.seed, blockIndex));
+        auto const first = blockIndex * blockSize;
+        auto const last = std::min(first + blockSize, options.sampleCount);
+        auto &block = blocks[blockIndex];
+        for (auto si = first; si < last; ++si) {
+          double keyWeight = 0;
+          for (std::size_t vi = 0; vi < dims.vectorCount(); ++vi) {
+            auto const *const cdf =
+                tilted.cdf.data() + dims.scoresBeforeCount(vi);
+            auto const subkeyCount = dims.subkeyCount(vi);
+            auto const u = unitInterval(rng) * cdf[subkeyCount - 1];
+            auto const ski = std::min<std::size_t>(
+                std::upper_bound(cdf, cdf + subkeyCount, u) - cdf,
+                subkeyCount - 1);
+            keyWeight += static_cast<double>(weights(vi, ski));
+          }
+          if (keyWeight < target) {
+            auto const x = std::exp(tilted.lambda * (keyWeight - target));
+            block.sum += x;
+            block.sumSquares += x * x;
+            ++block.hits;
+          }
+        }
+      });
+
+  // summed in block order, so the total does not depend on the schedule
+  BlockSums total;
+  for (auto const &block : blocks) {
+    total.sum += block.sum;
+    total.sumSquares += block.sumSquares;
+    total.hits += block.hits;
+  }
+  auto const n = static_cast<double>(options.sampleCount);
+  auto const mean = total.sum / n;
+  auto const variance =
+      std::max(0.0, total.sumSquares / n - mean * mean) / std::max(1.0, n - 1);
+  auto const halfWidth = options.z * std::sqrt(variance);
+
+  auto const scale = tilted.log2Z + tilted.lambda * target / std::log(2.0);
+  auto const toLog2 = [scale](double value) {
+    return value > 0 ? scale + std::log2(value)
+                     : -std::numeric_limits<double>::infinity();
+  };
+  return SampledRank{toLog2(mean), toLog2(mean - halfWidth),
+                     toLog2(mean + halfWidth), options.sampleCount,
+                     total.hits};
+}
+
+} /* namespace rankcpp */
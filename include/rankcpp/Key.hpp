@@ -1,6 +1,7 @@
 #pragma once
 
 #include <rankcpp/BitSpan.hpp>
+#include <rankcpp/utils/Bits.hpp>
 #include <rankcpp/utils/Encoding.hpp>
 
 #include <gsl/span>
@@ -9,13 +10,16 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
+#include <ostream>
 #include <random>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace rankcpp {
 
@@ -34,7 +38,7 @@ public:
       std::array<ByteType, ByteCount> const &byteArray) noexcept
       : bytes(byteArray) {}
 
-  explicit Key(std::string const &hex) {
+  explicit Key(std::string_view hex) {
     // check for the correct number of characters in the hex string
     if (hex.length() != ByteCount * 2) {
       throw std::length_error("hex string needs to be of length " +
@@ -69,6 +73,14 @@ public:
       throw std::out_of_range(
           "insufficient space in IntType to store subkey value");
     }
+    if (subkey.end() >= ByteCount * 8) {
+      throw std::out_of_range("subkey lies beyond the end of the key");
+    }
+
+    if (subkey.count() <= 64) {
+      return static_cast<IntType>(loadBitsLe(bytes.data(), ByteCount,
+                                             subkey.start(), subkey.count()));
+    }
 
     IntType value{0};
     for (auto bit : ranges::views::iota(subkey.start(), subkey.end() + 1)) {
@@ -83,17 +95,61 @@ public:
     return value;
   }
 
+  // sets the bits of subkey to the low subkey.count() bits of value
+  void setSubkeyValue(BitSpan subkey, std::uint64_t value) {
+    if (subkey.count() > 64) {
+      throw std::out_of_range("subkey is wider than 64 bits");
+    }
+    if (subkey.end() >= ByteCount * 8) {
+      throw std::out_of_range("subkey lies beyond the end of the key");
+    }
+
+    auto bit = subkey.start();
+    auto remaining = subkey.count();
+    while (remaining > 0) {
+      auto const offset = bit % 8;
+      auto const taken = std::min(8 - offset, remaining);
+      auto const mask = static_cast<ByteType>(lowBitsMask(taken) << offset);
+      auto &byte = bytes[bit / 8];
+      byte = static_cast<ByteType>((byte & ~mask) | ((value << offset) & mask));
+      value >>= taken;
+      bit += taken;
+      remaining -= taken;
+    }
+  }
+
+  /**
+   * subkeyValue for a span known at compile time, which reduces to a load of
+   * exactly the bytes the span covers, a shift and a mask (or to a plain byte
+   * read for byte-aligned 8-bit spans).
+   */
+  template <std::uint32_t Start, std::uint32_t Count,
+            typename IntType = std::size_t>
+  constexpr auto subkeyValue() const noexcept -> IntType {
+    static_assert(Count > 0, "subkey must be at least 1 bit");
+    static_assert(Count <= 64 && Count <= std::numeric_limits<IntType>::digits,
+                  "insufficient space in IntType to store subkey value");
+    static_assert(Start + Count <= ByteCount * 8,
+                  "subkey lies beyond the end of the key");
+    return static_cast<IntType>(
+        loadBitsLe(bytes.data(), ByteCount, Start, Count));
+  }
+
   template <typename IntType> auto asLeIntegerValue() const -> IntType {
     if (BitLen > std::numeric_limits<IntType>::digits) {
       throw std::out_of_range("insufficient space in IntType to store key");
     }
 
-    IntType value{0};
-    for (auto b : ranges::views::iota(std::size_t{0}, bytes.size())) {
-      IntType const byteValue{bytes[b]};
-      value += byteValue << (b * 8);
+    if constexpr (ByteCount <= 8) {
+      return static_cast<IntType>(loadLe64(bytes.data(), ByteCount));
+    } else {
+      IntType value{0};
+      for (auto b : ranges::views::iota(std::size_t{0}, bytes.size())) {
+        IntType const byteValue{bytes[b]};
+        value += byteValue << (b * 8);
+      }
+      return value;
     }
-    return value;
   }
 
 private:
@@ -112,4 +168,71 @@ auto randomKey(RngType &rng) -> Key<BitLen> {
   return Key<BitLen>(bytes);
 }
 
+namespace detail {
+
+// calls fn with every non-blank line of text, without any trailing '\r'
+template <typename Function>
+void forEachLine(std::string_view text, Function &&fn) {
+  while (!text.empty()) {
+    auto const end = text.find('\n');
+    auto line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    if (!line.empty()) {
+      fn(line);
+    }
+  }
+}
+
+} /* namespace detail */
+
+// the number of keys parseHexKeys will find in text
+inline auto hexKeyCount(std::string_view text) -> std::size_t {
+  std::size_t count = 0;
+  detail::forEachLine(text, [&count](std::string_view /*unused*/) { ++count; });
+  return count;
+}
+
+/**
+ * Parses text holding one hex key per line (such as a file opened with
+ * MappedFile) straight into keys, without allocating.  Blank lines are
+ * skipped.  Returns the number of keys parsed; throws std::length_error if
+ * there are more keys than room in keys.
+ */
+template <std::uint32_t BitLen>
+auto parseHexKeys(std::string_view text, gsl::span<Key<BitLen>> keys)
+    -> std::size_t {
+  std::size_t count = 0;
+  detail::forEachLine(text, [&](std::string_view line) {
+    if (count == keys.size()) {
+      throw std::length_error("more than " + std::to_string(keys.size()) +
+                              " keys in text");
+    }
+    keys[count] = Key<BitLen>(line);
+    ++count;
+  });
+  return count;
+}
+
+// writes keys to os as lowercase hex, one key per line
+template <std::uint32_t BitLen>
+void writeHexKeys(std::ostream &os, gsl::span<Key<BitLen> const> keys) {
+  constexpr std::size_t const lineLength = 2 * Key<BitLen>::ByteCount + 1;
+  std::array<char, 64 * lineLength> buffer{};
+  std::size_t used = 0;
+  for (auto const &key : keys) {
+    if (used == buffer.size()) {
+      os.write(buffer.data(), static_cast<std::streamsize>(used));
+      used = 0;
+    }
+    bytesToHex(key.asBytes(),
+               gsl::span<char>(buffer.data() + used, lineLength - 1));
+    buffer[used + lineLength - 1] = '\n';
+    used += lineLength;
+  }
+  os.write(buffer.data(), static_cast<std::streamsize>(used));
+}
+
 } /* namespace rankcpp */
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+/** \file
+ * \brief Observing and interrupting long running rank computations
+ *
+ */
+
+namespace rankcpp {
+
+/**
+ * A snapshot of a rank computation, taken each time a distinguishing vector
+ * has been folded into the DP.  operations counts inner loop additions and
+ * bytesTouched is the RankType traffic those additions and the buffer swaps
+ * imply.  eta extrapolates the mean time per vector.
+ */
+struct RankProgress {
+  std::size_t vectorsCompleted;
+  std::size_t vectorCount;
+  std::uint64_t operations;
+  std::uint64_t bytesTouched;
+  std::chrono::duration<double> elapsed;
+  std::chrono::duration<double> eta;
+};
+
+class RankCancelled : public std::runtime_error {
+public:
+  RankCancelled() : std::runtime_error("rank computation was cancelled") {}
+};
+
+/**
+ * Passed to the rank functions in place of a monitor when nothing is
+ * observing them; every call compiles away.
+ */
+struct NullRankMonitor {
+  static constexpr bool const enabled = false;
+
+  constexpr void start(std::size_t /*unused*/) noexcept {}
+  constexpr void addOperations(std::uint64_t /*unused*/,
+                               std::uint64_t /*unused*/) noexcept {}
+  constexpr void vectorCompleted() noexcept {}
+};
+
+/**
+ * Calls callback with a RankProgress after every distinguishing vector, then
+ * throws RankCancelled if cancel has been set.
+ */
+template <typename Callback> class RankMonitor {
+public:
+  static constexpr bool const enabled = true;
+
+  explicit RankMonitor(Callback callback,
+                       std::atomic<bool> const *cancel = nullptr)
+      : callback_(std::move(callback)), cancel_(cancel) {}
+
+  void start(std::size_t vectorCount) {
+    start_ = Clock::now();
+    progress_ = RankProgress{0, vectorCount, 0, 0, {}, {}};
+  }
+
+  void addOperations(std::uint64_t operations,
+                     std::uint64_t bytesTouched) noexcept {
+    progress_.operations += operations;
+    progress_.bytesTouched += bytesTouched;
+  }
+
+  void vectorCompleted() {
+    ++progress_.vectorsCompleted;
+    progress_.elapsed = Clock::now() - start_;
+    auto const remaining =
+        progress_.vectorCount - progress_.vectorsCompleted;
+    progress_.eta = progress_.elapsed *
+                    (static_cast<double>(remaining) /
+                     static_cast<double>(progress_.vectorsCompleted));
+    callback_(progress_);
+
+    if (cancel_ != nullptr && cancel_->load(std::memory_order_relaxed)) {
+      throw RankCancelled();
+    }
+  }
+
+  auto progress() const noexcept -> RankProgress const & { return progress_; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  Callback callback_;
+  std::atomic<bool> const *cancel_;
+  Clock::time_point start_{};
+  RankProgress progress_{0, 0, 0, 0, {}, {}};
+};
+
+} /* namespace rankcpp */
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Monitor.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/MappedFile.hpp>
+#include <rankcpp/utils/Storable.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <unistd.h>
+
+/** \file
+ * \brief Ranking every weight with DP buffers kept in files (POSIX only)
+ *
+ */
+
+namespace rankcpp {
+
+/**
+ * Where and how rankAllWeightsToFile keeps its DP buffers.  directory should
+ * be on local disk with room for two buffers of maxWeight RankTypes.  Each
+ * pass over a distinguishing vector works through curr blockBytes at a time,
+ * asking the kernel to read in the part of prev the next block will add up
+ * while it works on the current one.
+ */
+struct OutOfCoreOptions {
+  std::string directory{std::filesystem::temp_directory_path().string()};
+  std::size_t blockBytes{std::size_t{64} << 20U};
+};
+
+namespace detail {
+
+/**
+ * An array of count copies of value in a mapped file that is deleted once the
+ * array is destroyed, unless it is released first.
+ */
+template <typename T> class FileArray {
+public:
+  FileArray(std::string path, std::size_t count, T const &value)
+      : path_(std::move(path)), file_(path_, count * sizeof(T)),
+        count_(count) {
+    std::uninitialized_fill_n(data(), count_, value);
+  }
+
+  FileArray(FileArray const &) = delete;
+  auto operator=(FileArray const &) -> FileArray & = delete;
+
+  ~FileArray() {
+    if (!released_) {
+      std::error_code ignored;
+      std::filesystem::remove(path_, ignored);
+    }
+  }
+
+  auto data() const noexcept -> T * {
+    return reinterpret_cast<T *>(file_.data());
+  }
+
+  auto size() const noexcept -> std::size_t { return count_; }
+
+  void willNeed(std::size_t first, std::size_t count) const noexcept {
+    file_.willNeed(first * sizeof(T), count * sizeof(T));
+  }
+
+  // keeps the file on disk, writing it back first
+  void release() {
+    file_.flush();
+    released_ = true;
+  }
+
+private:
+  std::string path_;
+  WritableMappedFile file_;
+  std::size_t count_;
+  bool released_{false};
+};
+
+inline auto scratchPath(std::string const &directory, char const *name)
+    -> std::string {
+  static std::atomic<std::uint64_t> counter{0};
+  auto const file = "rankcpp-" + std::to_string(::getpid()) + "-" +
+                    std::to_string(counter++) + "-" + name + ".dp";
+  return (std::filesystem::path(directory) / file).string();
+}
+
+} /* namespace detail */
+
+/**
+ * rankAllWeights for weights too large to rank in memory.  The prev and curr
+ * buffers are files mapped from options.directory, which the kernel pages in
+ * and out as the DP streams through them, and which are deleted afterwards.
+ * Entry i of the maxWeight RankTypes written to outputPath is the number of
+ * keys with a weight below i + 1, as rankAllWeights returns.
+ */
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType, class MonitorType>
+void rankAllWeightsToFile(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    std::string const &outputPath, OutOfCoreOptions const &options,
+    MonitorType &monitor) {
+  static_assert(IsBitwiseStorableV<RankType>,
+                "RankType must be bitwise storable to keep it in a file");
+  if (maxWeight == 0) {
+    throw std::invalid_argument("The max weight ranked up to must > 0");
+  }
+
+  auto const weightCount = static_cast<std::size_t>(maxWeight);
+  auto const blockLength =
+      std::max<std::size_t>(1, options.blockBytes / sizeof(RankType));
+  auto prev = std::make_unique<detail::FileArray<RankType>>(
+      detail::scratchPath(options.directory, "prev"), weightCount,
+      RankType{1});
+  auto curr = std::make_unique<detail::FileArray<RankType>>(
+      detail::scratchPath(options.directory, "curr"), weightCount,
+      RankType{0});
+
+  auto const &dims = weights.dimensions();
+  monitor.start(dims.vectorCount());
+
+  for (auto vi = dims.vectorCount(); vi-- > 0;) {
+    auto *const currData = curr->data();
+    auto const *const prevData = prev->data();
+    auto const subkeyCount = dims.subkeyCount(vi);
+    auto minWeight = std::numeric_limits<std::size_t>::max();
+    std::size_t maxWeight = 0;
+    for (std::size_t ski = 0; ski < subkeyCount; ++ski) {
+      auto const weight = static_cast<std::size_t>(weights(vi, ski));
+      minWeight = std::min(minWeight, weight);
+      maxWeight = std::max(maxWeight, weight);
+    }
+
+    // curr[c] is the sum over subkeys of prev[c + weight], so each block of
+    // curr is finished before moving on and is only written once.  The next
+    // block of curr reads prev from last + minWeight to its own end plus
+    // maxWeight; curr itself is about to be overwritten, so is not read ahead
+    for (std::size_t first = 0; first < weightCount; first += blockLength) {
+      auto const last = std::min(first + blockLength, weightCount);
+      if (last < weightCount && minWeight < weightCount - last) {
+        auto const readFirst = last + minWeight;
+        auto const readLast =
+            std::min(weightCount, last + std::min(blockLength, weightCount) +
+                                      std::min(maxWeight, weightCount));
+        prev->willNeed(readFirst, readLast - readFirst);
+      }
+
+      std::fill(currData + first, currData + last, RankType{0});
+      for (std::size_t ski = 0; ski < subkeyCount; ++ski) {
+        auto const weight = static_cast<std::size_t>(weights(vi, ski));
+        if (weight >= weightCount) {
+          continue;
+        }
+        auto const end = std::min(last, weightCount - weight);
+        auto const operations = end > first ? end - first : 0;
+        detail::addRanks(currData + first, prevData + first + weight,
+                         operations);
+        if constexpr (MonitorType::enabled) {
+          monitor.addOperations(operations,
+                                3 * operations * sizeof(RankType));
+        }
+      }
+    }
+    std::swap(prev, curr);
+    monitor.vectorCompleted();
+  }
+
+  // prev holds the ranks in descending order of weight
+  detail::FileArray<RankType> output(outputPath, weightCount, RankType{0});
+  auto const *const ranks = prev->data();
+  std::reverse_copy(ranks, ranks + weightCount, output.data());
+  output.release();
+}
+
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType>
+void rankAllWeightsToFile(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    std::string const &outputPath, OutOfCoreOptions const &options = {}) {
+  NullRankMonitor monitor;
+  rankAllWeightsToFile<RankType, WeightType, DimensionsType>(
+      maxWeight, weights, outputPath, options, monitor);
+}
+
+} /* namespace rankcpp */
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <rankcpp/Key.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/ScoresTable.hpp>
+#include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/Numeric.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+/** \file
+ * \brief Choosing and refining the precision handed to mapToWeight
+ *
+ */
+
+namespace rankcpp {
+
+/**
+ * Limits on the search for a sufficient precision.  The precision starts at
+ * minPrecisionBits and is raised by stepBits until the rank bounds are at most
+ * targetLog2Width bits apart, or until running the next precision would break
+ * one of the budgets.
+ */
+struct PrecisionBudget {
+  double targetLog2Width{1.0};
+  std::uint32_t minPrecisionBits{8};
+  std::uint32_t maxPrecisionBits{24};
+  std::uint32_t stepBits{1};
+  std::chrono::duration<double> timeBudget{
+      std::numeric_limits<double>::infinity()};
+  std::size_t memoryBudgetBytes{std::numeric_limits<std::size_t>::max()};
+};
+
+enum class PrecisionStop {
+  TargetReached,
+  MaxPrecision,
+  TimeBudget,
+  MemoryBudget
+};
+
+template <typename RankType> struct AdaptiveRank {
+  std::uint32_t precisionBits;
+  RankBounds<RankType> bounds;
+  PrecisionStop reason;
+};
+
+/**
+ * One step of a progressive ranking.  elapsed is measured from the start of
+ * the call, not of this step.
+ */
+template <typename RankType> struct RankEstimate {
+  std::uint32_t precisionBits;
+  RankBounds<RankType> bounds;
+  std::chrono::duration<double> elapsed;
+};
+
+namespace detail {
+
+// the two interleaved DP buffers used by rankBounds
+template <typename RankType, typename WeightType>
+constexpr auto rankBoundsBytes(WeightType maxKeyWeight) -> std::size_t {
+  return 4 * static_cast<std::size_t>(maxKeyWeight) * sizeof(RankType);
+}
+
+/**
+ * Ranks the key at each precision from minBits to maxBits.  beforeStep is
+ * given the precision, the ceil weight of the key and the time elapsed since
+ * the call began once the tables for a step are mapped, and afterStep is
+ * given each estimate; returning false from either ends the refinement.
+ * Returns the number of completed steps.
+ */
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          typename ScoresType, class DimensionsType, class StorageType,
+          typename BeforeStep, typename AfterStep>
+auto refinePrecision(
+    Key<KeyLenBits> const &key,
+    ScoresTable<ScoresType, DimensionsType, StorageType> const &scores,
+    std::uint32_t minBits, std::uint32_t maxBits, std::uint32_t stepBits,
+    BeforeStep &&beforeStep, AfterStep &&afterStep) -> std::size_t {
+  if (stepBits == 0) {
+    throw std::invalid_argument("precision step must be > 0 bits");
+  }
+  if (minBits > maxBits) {
+    throw std::invalid_argument(
+        "minimum precision is above the maximum precision");
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto const start = Clock::now();
+  std::size_t steps = 0;
+
+  for (std::uint32_t precisionBits = minBits; precisionBits <= maxBits;
+       precisionBits += stepBits) {
+    auto const tables =
+        mapToWeightBounds<ScoresType, WeightType>(scores, precisionBits);
+    if (!beforeStep(precisionBits, tables.ceil.weightForKey(key),
+                    std::chrono::duration<double>(Clock::now() - start))) {
+      break;
+    }
+
+    RankEstimate<RankType> const estimate{
+        precisionBits,
+        rankBounds<KeyLenBits, RankType>(key, tables.floor, tables.ceil),
+        Clock::now() - start};
+    ++steps;
+    if (!afterStep(estimate)) {
+      break;
+    }
+  }
+  return steps;
+}
+
+} /* namespace detail */
+
+/**
+ * Ranks the key at increasing precisions, reusing the same scores, and hands
+ * every intermediate estimate to onEstimate.  The refinement ends once
+ * targetBits has been ranked or onEstimate returns false.  Returns the last
+ * estimate made.
+ */
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          typename ScoresType, class DimensionsType, class StorageType,
+          typename Callback>
+auto rankProgressive(
+    Key<KeyLenBits> const &key,
+    ScoresTable<ScoresType, DimensionsType, StorageType> const &scores,
+    std::uint32_t startBits, std::uint32_t targetBits, Callback &&onEstimate,
+    std::uint32_t stepBits = 1) -> RankEstimate<RankType> {
+  RankEstimate<RankType> last{0, {RankType{0}, RankType{0}}, {}};
+  detail::refinePrecision<KeyLenBits, RankType, WeightType>(
+      key, scores, startBits, targetBits, stepBits,
+      [](std::uint32_t /*unused*/, WeightType /*unused*/,
+         std::chrono::duration<double> /*unused*/) { return true; },
+      [&](RankEstimate<RankType> const &estimate) {
+        last = estimate;
+        return static_cast<bool>(onEstimate(estimate));
+      });
+  return last;
+}
+
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          typename ScoresType, class DimensionsType, class StorageType>
+auto rankAdaptive(
+    Key<KeyLenBits> const &key,
+    ScoresTable<ScoresType, DimensionsType, StorageType> const &scores,
+    PrecisionBudget const &budget = {}) -> AdaptiveRank<RankType> {
+  AdaptiveRank<RankType> result{0, {RankType{0}, RankType{0}},
+                                PrecisionStop::MaxPrecision};
+  // the time at which the DP of the current step started, and how long the
+  // DP of the last completed step took
+  std::chrono::duration<double> stepStart{0.0};
+  std::chrono::duration<double> lastRunTime{0.0};
+  WeightType lastKeyWeight{0};
+  bool haveResult = false;
+
+  auto const beforeStep = [&](std::uint32_t /*unused*/, WeightType keyWeight,
+                              std::chrono::duration<double> elapsed) {
+    if (detail::rankBoundsBytes<RankType>(keyWeight) >
+        budget.memoryBudgetBytes) {
+      if (!haveResult) {
+        throw std::invalid_argument("memory budget is too small to rank at "
+                                    "the minimum precision");
+      }
+      result.reason = PrecisionStop::MemoryBudget;
+      return false;
+    }
+
+    // the DP runs in time linear in the key weight, so scale the last run
+    if (haveResult) {
+      auto const predicted = lastRunTime * (static_cast<double>(keyWeight) /
+                                            static_cast<double>(lastKeyWeight));
+      if (elapsed + predicted > budget.timeBudget) {
+        result.reason = PrecisionStop::TimeBudget;
+        return false;
+      }
+    }
+    lastKeyWeight = keyWeight;
+    stepStart = elapsed;
+    return true;
+  };
+
+  auto const afterStep = [&](RankEstimate<RankType> const &estimate) {
+    result.precisionBits = estimate.precisionBits;
+    result.bounds = estimate.bounds;
+    lastRunTime = estimate.elapsed - stepStart;
+    haveResult = true;
+
+    if (estimate.bounds.log2Width() <= budget.targetLog2Width) {
+      result.reason = PrecisionStop::TargetReached;
+      return false;
+    }
+    return true;
+  };
+
+  detail::refinePrecision<KeyLenBits, RankType, WeightType>(
+      key, scores, budget.minPrecisionBits, budget.maxPrecisionBits,
+      budget.stepBits, beforeStep, afterStep);
+  return result;
+}
+
+} /* namespace rankcpp */
@@ -3,11 +3,14 @@
 #include <rankcpp/BitSpan.hpp>
 #include <rankcpp/Dimensions.hpp>
 #include <rankcpp/Key.hpp>
+#include <rankcpp/Monitor.hpp>
 #include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/Numeric.hpp>
 
 #include <range/v3/all.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <stdexcept>
@@ -16,36 +19,101 @@
 
 namespace rankcpp {
 
-template <typename RankType, typename WeightType, class DimensionsType>
+/**
+ * The DP buffers used by rank.  Keeping one between calls means that ranking
+ * many tables in a row only allocates when the weight grows.
+ */
+template <typename RankType> class RankWorkspace {
+public:
+  // sizes both buffers for maxWeight, with curr zeroed and prev set to 1
+  void reset(std::size_t maxWeight) {
+    curr_.assign(maxWeight, RankType{0});
+    prev_.assign(maxWeight, RankType{1});
+  }
+
+  auto curr() noexcept -> std::vector<RankType> & { return curr_; }
+
+  auto prev() noexcept -> std::vector<RankType> & { return prev_; }
+
+private:
+  std::vector<RankType> curr_;
+  std::vector<RankType> prev_;
+};
+
+namespace detail {
+
+// curr[c] += prev[c] for every c < count, the inner loop of the rank DPs
+template <typename RankType>
+inline void addRanks(RankType *curr, RankType const *prev,
+                     std::size_t count) noexcept {
+  for (std::size_t c = 0; c < count; ++c) {
+    curr[c] += prev[c];
+  }
+}
+
+/*
+ * built by rankcpp_compiled for several instruction sets, one of which is
+ * picked for the CPU when the program loads (see Compiled.hpp).  This changes
+ * the body of every rank function over std::uint64_t, so all translation
+ * units of a program must agree on RANKCPP_COMPILED: linking rankcpp_compiled
+ * defines it for each target that uses it, and it must not be defined by hand
+ * for only some of them.
+ */
+#ifdef RANKCPP_COMPILED
+void compiledAddRanks(std::uint64_t *curr, std::uint64_t const *prev,
+                      std::size_t count) noexcept;
+
+template <>
+inline void addRanks<std::uint64_t>(std::uint64_t *curr,
+                                    std::uint64_t const *prev,
+                                    std::size_t count) noexcept {
+  compiledAddRanks(curr, prev, count);
+}
+#endif
+
+} /* namespace detail */
+
+/**
+ * The rank functions taking a MonitorType report their progress to it after
+ * every distinguishing vector (see Monitor.hpp); those without one pass a
+ * NullRankMonitor, for which the instrumentation compiles away.
+ */
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType, class MonitorType>
 auto rank(WeightType maxWeight,
-          WeightTable<WeightType, DimensionsType> const &weights) -> RankType {
+          WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+          RankWorkspace<RankType> &workspace, MonitorType &monitor)
+    -> RankType {
   if (maxWeight == 0) {
     throw std::invalid_argument("The weight to rank to must be > 0");
   }
 
-  std::vector<RankType> curr(maxWeight);
-  std::vector<RankType> prev(maxWeight, RankType{1});
+  workspace.reset(maxWeight);
+  auto &curr = workspace.curr();
+  auto &prev = workspace.prev();
 
   auto const &dims = weights.dimensions();
   auto const vecRange = dims.vectorRange() | ranges::views::reverse;
   auto const &subkeys = dims.asSpans();
+  monitor.start(dims.vectorCount());
 
   for (auto vi : vecRange | ranges::views::drop_last(1)) {
     for (auto ski : subkeys[vi].subkeyRange() | ranges::views::reverse) {
       auto const weight = weights(vi, ski);
       if (maxWeight >= weight) {
         WeightType const currStart = maxWeight - weight;
-        auto const currRange = ranges::views::iota(WeightType{0}, currStart) |
-                               ranges::views::reverse;
-        auto const prevRange =
-            ranges::views::iota(weight, maxWeight) | ranges::views::reverse;
-        for (auto const [cwi, pwi] : ranges::views::zip(currRange, prevRange)) {
-          curr[cwi] += prev[pwi];
+        detail::addRanks(curr.data(), prev.data() + weight, currStart);
+        if constexpr (MonitorType::enabled) {
+          monitor.addOperations(currStart, 3 * currStart * sizeof(RankType));
         }
       }
     }
     std::copy(std::cbegin(curr), std::cend(curr), std::begin(prev));
     std::fill(std::begin(curr), std::end(curr), 0);
+    if constexpr (MonitorType::enabled) {
+      monitor.addOperations(0, 3 * std::uint64_t{maxWeight} * sizeof(RankType));
+    }
+    monitor.vectorCompleted();
   }
 
   // can skip all but nodes with weight 0 in the last vector
@@ -55,13 +123,39 @@ auto rank(WeightType maxWeight,
       curr[0] += prev[weight];
     }
   }
+  if constexpr (MonitorType::enabled) {
+    auto const subkeyCount = dims.subkeyCount(vecRange.back());
+    monitor.addOperations(subkeyCount, 2 * subkeyCount * sizeof(RankType));
+  }
+  monitor.vectorCompleted();
   return curr[0];
 }
 
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType, class MonitorType>
+auto rank(WeightType maxWeight,
+          WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+          MonitorType &monitor) -> RankType {
+  RankWorkspace<RankType> workspace;
+  return rank<RankType, WeightType, DimensionsType>(maxWeight, weights,
+                                                    workspace, monitor);
+}
+
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType>
+auto rank(WeightType maxWeight,
+          WeightTable<WeightType, DimensionsType, StorageType> const &weights)
+    -> RankType {
+  NullRankMonitor monitor;
+  return rank<RankType, WeightType, DimensionsType>(maxWeight, weights,
+                                                    monitor);
+}
+
 template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
-          class DimensionsType>
+          class DimensionsType, class StorageType>
 auto rank(Key<KeyLenBits> const &key,
-          WeightTable<WeightType, DimensionsType> const &weights) -> RankType {
+          WeightTable<WeightType, DimensionsType, StorageType> const &weights)
+    -> RankType {
   auto const keyWeight = weights.weightForKey(key);
   if (keyWeight == 0) {
     throw std::invalid_argument("Weight for the known key must be > 0");
@@ -70,10 +164,12 @@ auto rank(Key<KeyLenBits> const &key,
   return rank<RankType, WeightType, DimensionsType>(keyWeight, weights);
 }
 
-template <typename RankType, typename WeightType, class DimensionsType>
-auto rankLowMem(WeightType maxWeight,
-                WeightTable<WeightType, DimensionsType> const &weights)
-    -> RankType {
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType, class MonitorType>
+auto rankLowMem(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    MonitorType &monitor) -> RankType {
   if (maxWeight == 0) {
     throw std::invalid_argument("The weight to rank to must be > 0");
   }
@@ -84,6 +180,18 @@ auto rankLowMem(WeightType maxWeight,
   auto const vecRange = dims.vectorRange() | ranges::views::reverse;
   auto const weightRange = ranges::views::iota(WeightType{0}, maxWeight);
   auto const &subkeys = dims.asSpans();
+  monitor.start(dims.vectorCount());
+
+  // every weight visits every subkey, reading at most one entry of curr
+  auto const reportVector = [&](std::size_t vectorIndex) {
+    if constexpr (MonitorType::enabled) {
+      auto const operations =
+          std::uint64_t{maxWeight} * dims.subkeyCount(vectorIndex);
+      monitor.addOperations(operations,
+                            (operations + maxWeight) * sizeof(RankType));
+    }
+    monitor.vectorCompleted();
+  };
 
   // treat the last distinguishing vector separately
   for (auto wi : weightRange) {
@@ -96,6 +204,7 @@ auto rankLowMem(WeightType maxWeight,
     }
     curr[wi] = temp;
   }
+  reportVector(vecRange.front());
 
   for (auto vi :
        vecRange | ranges::views::drop(1) | ranges::views::drop_last(1)) {
@@ -110,6 +219,7 @@ auto rankLowMem(WeightType maxWeight,
       }
       curr[wi] = temp;
     }
+    reportVector(vi);
   }
 
   // only need to look at weight 0 in the zeroth distinguishing vector
@@ -120,14 +230,32 @@ auto rankLowMem(WeightType maxWeight,
       temp += curr[weight];
     }
   }
+  if constexpr (MonitorType::enabled) {
+    auto const subkeyCount = dims.subkeyCount(vecRange.back());
+    monitor.addOperations(subkeyCount, subkeyCount * sizeof(RankType));
+  }
+  monitor.vectorCompleted();
 
   return temp;
 }
 
-template <typename RankType, typename WeightType, class DimensionsType>
-auto rankAllWeights(WeightType maxWeight,
-                    WeightTable<WeightType, DimensionsType> const &weights)
-    -> std::vector<RankType> {
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType>
+auto rankLowMem(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights)
+    -> RankType {
+  NullRankMonitor monitor;
+  return rankLowMem<RankType, WeightType, DimensionsType>(maxWeight, weights,
+                                                          monitor);
+}
+
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType, class MonitorType>
+auto rankAllWeights(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    MonitorType &monitor) -> std::vector<RankType> {
   if (maxWeight == 0) {
     throw std::invalid_argument("The max weight ranked up to must > 0");
   }
@@ -138,23 +266,25 @@ auto rankAllWeights(WeightType maxWeight,
 
   auto const vecRange = dims.vectorRange() | ranges::views::reverse;
   auto const &subkeys = dims.asSpans();
+  monitor.start(dims.vectorCount());
 
   for (auto vi : vecRange) {
     for (auto ski : subkeys[vi].subkeyRange() | ranges::views::reverse) {
       WeightType const weight = weights(vi, ski);
       if (maxWeight >= weight) {
         WeightType const currStart = maxWeight - weight;
-        auto const currRange = ranges::views::iota(WeightType{0}, currStart) |
-                               ranges::views::reverse;
-        auto const prevRange =
-            ranges::views::iota(weight, maxWeight) | ranges::views::reverse;
-        for (auto const [cwi, pwi] : ranges::views::zip(currRange, prevRange)) {
-          curr[cwi] += prev[pwi];
+        detail::addRanks(curr.data(), prev.data() + weight, currStart);
+        if constexpr (MonitorType::enabled) {
+          monitor.addOperations(currStart, 3 * currStart * sizeof(RankType));
         }
       }
     }
     std::copy(std::cbegin(curr), std::cend(curr), std::begin(prev));
     std::fill(std::begin(curr), std::end(curr), RankType{0});
+    if constexpr (MonitorType::enabled) {
+      monitor.addOperations(0, 3 * std::uint64_t{maxWeight} * sizeof(RankType));
+    }
+    monitor.vectorCompleted();
   }
 
   // the rank of each weight will be generated in a reverse order, so
@@ -164,4 +294,136 @@ auto rankAllWeights(WeightType maxWeight,
   return prev;
 }
 
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType>
+auto rankAllWeights(
+    WeightType maxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights)
+    -> std::vector<RankType> {
+  NullRankMonitor monitor;
+  return rankAllWeights<RankType, WeightType, DimensionsType>(
+      maxWeight, weights, monitor);
+}
+
+/**
+ * An interval guaranteed to hold the rank of a key before its scores were
+ * quantised into weights.
+ */
+template <typename RankType> struct RankBounds {
+  RankType lower;
+  RankType upper;
+
+  // +inf when the lower bound is 0 and the upper is not
+  auto log2Width() const -> double {
+    if (upper == RankType{0}) {
+      return 0.0;
+    }
+    return approxLog2(upper) - approxLog2(lower);
+  }
+};
+
+/**
+ * Runs the DPs for the lower and upper bounds side by side.  Entry 2w of each
+ * buffer belongs to the lower bound (ceil weights, ranked to lowerMaxWeight)
+ * and entry 2w+1 to the upper bound (floor weights, ranked to upperMaxWeight),
+ * so both walk the dimensions and the buffers once.
+ */
+template <typename RankType, typename WeightType, class DimensionsType,
+          class StorageType>
+auto rankBounds(
+    WeightType lowerMaxWeight, WeightType upperMaxWeight,
+    WeightTable<WeightType, DimensionsType, StorageType> const &floorWeights,
+    WeightTable<WeightType, DimensionsType, StorageType> const &ceilWeights)
+    -> RankBounds<RankType> {
+  if (lowerMaxWeight == 0 || upperMaxWeight == 0) {
+    throw std::invalid_argument("The weights to rank to must be > 0");
+  }
+
+  auto const maxWeight = std::max(lowerMaxWeight, upperMaxWeight);
+  auto const bufferSize = 2 * static_cast<std::size_t>(maxWeight);
+  std::vector<RankType> curr(bufferSize);
+  std::vector<RankType> prev(bufferSize);
+  for (auto wi : ranges::views::iota(WeightType{0}, maxWeight)) {
+    auto const index = 2 * static_cast<std::size_t>(wi);
+    prev[index] = (wi < lowerMaxWeight) ? RankType{1} : RankType{0};
+    prev[index + 1] = (wi < upperMaxWeight) ? RankType{1} : RankType{0};
+  }
+
+  auto const &dims = floorWeights.dimensions();
+  auto const vecRange = dims.vectorRange() | ranges::views::reverse;
+  auto const &subkeys = dims.asSpans();
+
+  for (auto vi : vecRange | ranges::views::drop_last(1)) {
+    for (auto ski : subkeys[vi].subkeyRange()) {
+      auto const lowerWeight = ceilWeights(vi, ski);
+      auto const upperWeight = floorWeights(vi, ski);
+      WeightType const lowerEnd =
+          (lowerMaxWeight > lowerWeight) ? lowerMaxWeight - lowerWeight : 0;
+      WeightType const upperEnd =
+          (upperMaxWeight > upperWeight) ? upperMaxWeight - upperWeight : 0;
+      auto const lowerShift = 2 * static_cast<std::size_t>(lowerWeight);
+      auto const upperShift = 2 * static_cast<std::size_t>(upperWeight);
+
+      auto const sharedEnd = std::min(lowerEnd, upperEnd);
+      for (auto cwi : ranges::views::iota(WeightType{0}, sharedEnd)) {
+        auto const index = 2 * static_cast<std::size_t>(cwi);
+        curr[index] += prev[index + lowerShift];
+        curr[index + 1] += prev[index + 1 + upperShift];
+      }
+      for (auto cwi : ranges::views::iota(sharedEnd, lowerEnd)) {
+        auto const index = 2 * static_cast<std::size_t>(cwi);
+        curr[index] += prev[index + lowerShift];
+      }
+      for (auto cwi : ranges::views::iota(sharedEnd, upperEnd)) {
+        auto const index = 2 * static_cast<std::size_t>(cwi);
+        curr[index + 1] += prev[index + 1 + upperShift];
+      }
+    }
+    std::copy(std::cbegin(curr), std::cend(curr), std::begin(prev));
+    std::fill(std::begin(curr), std::end(curr), RankType{0});
+  }
+
+  // as in rank, only weight 0 of the zeroth vector is needed
+  RankBounds<RankType> bounds{RankType{0}, RankType{0}};
+  for (auto ski : subkeys.front().subkeyRange()) {
+    auto const lowerWeight = ceilWeights(vecRange.back(), ski);
+    auto const upperWeight = floorWeights(vecRange.back(), ski);
+    if (lowerWeight < lowerMaxWeight) {
+      bounds.lower += prev[2 * static_cast<std::size_t>(lowerWeight)];
+    }
+    if (upperWeight < upperMaxWeight) {
+      bounds.upper += prev[2 * static_cast<std::size_t>(upperWeight) + 1];
+    }
+  }
+  return bounds;
+}
+
+/**
+ * Bounds the rank of the key using the floor and ceil tables produced by
+ * mapToWeightBounds.  Any key lighter under ceil than the known key is under
+ * floor is certainly ranked ahead of it, and any key ranked ahead of it must be
+ * lighter under floor than the known key is under ceil.
+ */
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          class DimensionsType, class StorageType>
+auto rankBounds(
+    Key<KeyLenBits> const &key,
+    WeightTable<WeightType, DimensionsType, StorageType> const &floorWeights,
+    WeightTable<WeightType, DimensionsType, StorageType> const &ceilWeights)
+    -> RankBounds<RankType> {
+  auto const floorKeyWeight = floorWeights.weightForKey(key);
+  auto const ceilKeyWeight = ceilWeights.weightForKey(key);
+  if (floorKeyWeight == 0) {
+    throw std::invalid_argument("Weight for the known key must be > 0");
+  }
+
+  auto bounds = rankBounds<RankType, WeightType, DimensionsType>(
+      floorKeyWeight, ceilKeyWeight, floorWeights, ceilWeights);
+  // the known key is counted in the upper bound whenever its weights differ
+  if (floorKeyWeight < ceilKeyWeight) {
+    bounds.upper -= RankType{1};
+  }
+  return bounds;
+}
+
 } /* namespace rankcpp */
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <rankcpp/Key.hpp>
+#include <rankcpp/Unrank.hpp>
+#include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/Parallel.hpp>
+#include <rankcpp/utils/Random.hpp>
+
+#include <gsl/span>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/** \file
+ * \brief Drawing keys uniformly from those below a weight
+ *
+ * A uniform index into the rank order is unranked, so every key with a
+ * weight below counts.maxWeight() is equally likely however small a share of
+ * the key space they are, at the cost of an unrank per key.
+ */
+
+namespace rankcpp {
+
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          class DimensionsType, class StorageType, class RandomBitGenerator>
+auto sampleKey(
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    SuffixCounts<RankType> const &counts, RandomBitGenerator &rng)
+    -> Key<KeyLenBits> {
+  if (counts.keyCount() == RankType{0}) {
+    throw std::domain_error("No keys weigh less than the max weight");
+  }
+  return unrank<KeyLenBits>(randomBelow(counts.keyCount(), rng), weights,
+                            counts);
+}
+
+/**
+ * Fills keys with uniform draws over threadCount threads.  Each block of 4096
+ * keys is drawn from its own Xoshiro256 seeded from seed, so the keys depend
+ * only on seed and not on the thread count.
+ */
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          class DimensionsType, class StorageType>
+void sampleKeys(
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    SuffixCounts<RankType> const &counts, gsl::span<Key<KeyLenBits>> keys,
+    std::uint64_t seed, std::size_t threadCount = 0) {
+  if (counts.keyCount() == RankType{0}) {
+    throw std::domain_error("No keys weigh less than the max weight");
+  }
+
+  std::size_t const blockSize = 4096;
+  auto const keyCount = static_cast<std::size_t>(keys.size());
+  auto const blockCount = (keyCount + blockSize - 1) / blockSize;
+  parallelFor(blockCount, threadCount,
+              [&](std::size_t blockIndex, std::size_t /*unused*/) {
+                Xoshiro256 rng(deriveSeed(seed, blockIndex));
+                auto const first = blockIndex * blockSize;
+                auto const last = std::min(first + blockSize, keyCount);
+                for (auto ki = first; ki < last; ++ki) {
+                  keys[ki] = sampleKey<KeyLenBits>(weights, counts, rng);
+                }
+              });
+}
+
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          class DimensionsType, class StorageType>
+auto sampleKeys(
+    WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+    SuffixCounts<RankType> const &counts, std::size_t keyCount,
+    std::uint64_t seed, std::size_t threadCount = 0)
+    -> std::vector<Key<KeyLenBits>> {
+  std::vector<Key<KeyLenBits>> keys(keyCount);
+  sampleKeys(weights, counts, gsl::span<Key<KeyLenBits>>(keys), seed,
+             threadCount);
+  return keys;
+}
+
+} /* namespace rankcpp */
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/ScoresTable.hpp>
+#include <rankcpp/utils/Numeric.hpp>
+#include <rankcpp/utils/Parallel.hpp>
+
+#include <gsl/span>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** \file
+ * \brief Accumulating per-trace log-likelihoods into scores as traces arrive
+ *
+ */
+
+namespace rankcpp {
+
+/**
+ * Sums the natural log-likelihood of every subkey hypothesis over the traces
+ * seen so far, in the same layout as a ScoresTable.  snapshot() turns the sums
+ * into the -log2 posterior scores mapToWeight expects at any point, so an
+ * attack can be ranked every few traces without rebuilding its tables.
+ */
+template <typename T = double, class DimensionsType = Dimensions>
+class ScoreAccumulator {
+  static_assert(std::is_floating_point_v<T>, "T must be a floating point type");
+
+public:
+  explicit ScoreAccumulator(DimensionsType dims, std::size_t threadCount = 0)
+      : dims_(std::move(dims)), logLikelihoods_(dims_.scoresCount()),
+        traceCounts_(dims_.vectorCount()), threadCount_(threadCount) {}
+
+  /**
+   * Adds a batch of traces for one distinguishing vector.  batch holds one row
+   * of subkeyCount(vectorIndex) log-likelihoods per trace.
+   */
+  void addLogLikelihoods(std::size_t vectorIndex, gsl::span<T const> batch) {
+    if (vectorIndex >= dims_.vectorCount()) {
+      throw std::out_of_range("no distinguishing vector " +
+                              std::to_string(vectorIndex));
+    }
+    auto const subkeyCount = dims_.subkeyCount(vectorIndex);
+    if (batch.size() % subkeyCount != 0) {
+      throw std::length_error("batch is not a whole number of traces of " +
+                              std::to_string(subkeyCount) + " hypotheses");
+    }
+    accumulate(vectorIndex, batch.data(), batch.size() / subkeyCount,
+               subkeyCount);
+  }
+
+  /**
+   * Adds a batch of traces for every distinguishing vector.  batch holds one
+   * row of scoresCount() log-likelihoods per trace, laid out as a ScoresTable
+   * is.  The vectors are updated in parallel.
+   */
+  void addTraces(gsl::span<T const> batch) {
+    auto const rowLength = dims_.scoresCount();
+    if (batch.size() % rowLength != 0) {
+      throw std::length_error("batch is not a whole number of traces of " +
+                              std::to_string(rowLength) + " log-likelihoods");
+    }
+    auto const traceCount = batch.size() / rowLength;
+    parallelFor(dims_.vectorCount(), threadCount_,
+                [&](std::size_t vectorIndex, std::size_t /*unused*/) {
+                  auto const offset = dims_.scoresBeforeCount(vectorIndex);
+                  accumulate(vectorIndex, batch.data() + offset, traceCount,
+                             rowLength);
+                });
+  }
+
+  // the number of traces added to a distinguishing vector
+  auto traceCount(std::size_t vectorIndex) const -> std::size_t {
+    return traceCounts_.at(vectorIndex);
+  }
+
+  /**
+   * Writes the scores of the traces so far into table, which may be a view.
+   * A vector without any traces gets the scores of a uniform posterior.
+   */
+  template <class StorageType>
+  void snapshot(ScoresTable<T, DimensionsType, StorageType> &table) const {
+    auto &scores = table.allScores();
+    if (scores.size() != logLikelihoods_.size()) {
+      throw std::length_error("table does not match the accumulator");
+    }
+    parallelFor(dims_.vectorCount(), threadCount_,
+                [&](std::size_t vectorIndex, std::size_t /*unused*/) {
+                  auto const offset = dims_.scoresBeforeCount(vectorIndex);
+                  auto const *const first = logLikelihoods_.data() + offset;
+                  logLikelihoodsToScores(
+                      first, first + dims_.subkeyCount(vectorIndex),
+                      scores.data() + offset);
+                });
+  }
+
+  auto snapshot() const -> ScoresTable<T, DimensionsType> {
+    ScoresTable<T, DimensionsType> table(dims_);
+    snapshot(table);
+    return table;
+  }
+
+  void reset() noexcept {
+    std::fill(std::begin(logLikelihoods_), std::end(logLikelihoods_), T{0});
+    std::fill(std::begin(traceCounts_), std::end(traceCounts_), 0);
+  }
+
+  auto dimensions() const -> DimensionsType const & { return dims_; }
+
+  auto logLikelihoods() const noexcept -> std::vector<T> const & {
+    return logLikelihoods_;
+  }
+
+private:
+  DimensionsType const dims_;
+  std::vector<T> logLikelihoods_;
+  std::vector<std::size_t> traceCounts_;
+  std::size_t threadCount_;
+
+  // adds traceCount rows, stride elements apart, to one vector's sums; the
+  // inner loop is contiguous so that it vectorizes
+  void accumulate(std::size_t vectorIndex, T const *rows,
+                  std::size_t traceCount, std::size_t stride) noexcept {
+    auto const subkeyCount = dims_.subkeyCount(vectorIndex);
+    auto *const sums =
+        logLikelihoods_.data() + dims_.scoresBeforeCount(vectorIndex);
+    for (std::size_t trace = 0; trace < traceCount; ++trace) {
+      auto const *const row = rows + trace * stride;
+      for (std::size_t hypothesis = 0; hypothesis < subkeyCount; ++hypothesis) {
+        sums[hypothesis] += row[hypothesis];
+      }
+    }
+    traceCounts_[vectorIndex] += traceCount;
+  }
+};
+
+} /* namespace rankcpp */
@@ -3,6 +3,8 @@
 #include <rankcpp/Dimensions.hpp>
 #include <rankcpp/utils/Numeric.hpp>
 
+#include <gsl/span>
+
 #include <range/v3/all.hpp>
 
 #include <algorithm>
@@ -16,23 +18,40 @@
 #include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace rankcpp {
 
-template <typename T, typename DimensionsType = Dimensions> class ScoresTable {
+/**
+ * The scores of every subkey of every distinguishing vector, stored in
+ * StorageType.  As with WeightTable, a gsl::span views scores owned elsewhere
+ * (see ScoresTableView) without copying them.
+ */
+template <typename T, typename DimensionsType = Dimensions,
+          class StorageType = std::vector<T>>
+class ScoresTable {
   static_assert(std::is_floating_point_v<T>, "T must be a floating point type");
 
 public:
+  using ScoresType = T;
+
   static constexpr T const epsilon = static_cast<T>(0.000001);
 
   explicit ScoresTable(DimensionsType dims)
       : dims_(dims), scores_(dims.scoresCount()) {}
 
-  ScoresTable(DimensionsType dims, std::vector<T> scores)
-      : dims_(std::move(dims)), scores_(std::move(scores)) {}
+  ScoresTable(DimensionsType dims, StorageType scores)
+      : dims_(std::move(dims)), scores_(std::move(scores)) {
+    if (scores_.size() != dims_.scoresCount()) {
+      throw std::length_error("scores need to be of length " +
+                              std::to_string(dims_.scoresCount()) +
+                              " but are of length " +
+                              std::to_string(scores_.size()));
+    }
+  }
 
   ScoresTable(DimensionsType dims, std::initializer_list<T> const &list)
       : dims_(dims), scores_(dims.scoresCount()) {
@@ -46,11 +65,11 @@ public:
   }
 
   auto score(std::size_t vectorIndex, std::size_t subkeyIndex) -> T & {
-    return scores_.at(dims_.scoresBeforeCount(vectorIndex) + subkeyIndex);
+    return scores_[checkedIndex(vectorIndex, subkeyIndex)];
   }
 
   auto score(std::size_t vectorIndex, std::size_t subkeyIndex) const -> T {
-    return scores_.at(dims_.scoresBeforeCount(vectorIndex) + subkeyIndex);
+    return scores_[checkedIndex(vectorIndex, subkeyIndex)];
   }
 
   auto operator()(std::size_t vectorIndex, std::size_t subkeyIndex) -> T & {
@@ -175,13 +194,32 @@ public:
     return merged;
   }
 
-  auto allScores() -> std::vector<T> & { return scores_; }
+  auto allScores() -> StorageType & { return scores_; }
 
-  auto allScores() const -> std::vector<T> const & { return scores_; }
+  auto allScores() const -> StorageType const & { return scores_; }
 
 private:
   DimensionsType const dims_;
-  std::vector<T> scores_;
+  StorageType scores_;
+
+  auto checkedIndex(std::size_t vectorIndex, std::size_t subkeyIndex) const
+      -> std::size_t {
+    auto const index = dims_.scoresBeforeCount(vectorIndex) + subkeyIndex;
+    if (index >= scores_.size()) {
+      throw std::out_of_range("score index " + std::to_string(index) +
+                              " is out of range");
+    }
+    return index;
+  }
 };
 
+// a ScoresTable over scores owned elsewhere
+template <typename T, class DimensionsType = Dimensions>
+using ScoresTableView = ScoresTable<T, DimensionsType, gsl::span<T>>;
+
+// a ScoresTable over read-only scores, such as those of a mapped file
+template <typename T, class DimensionsType = Dimensions>
+using ConstScoresTableView =
+    ScoresTable<T, DimensionsType, gsl::span<T const>>;
+
 } /* namespace rankcpp */
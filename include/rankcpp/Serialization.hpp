@@ -0,0 +1,336 @@
+#pragma once
+
+#include <rankcpp/BitSpan.hpp>
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/ScoresTable.hpp>
+#include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/Bits.hpp>
+#include <rankcpp/utils/MappedFile.hpp>
+
+#include <gsl/span>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/** \file
+ * \brief A binary file format for score and weight tables (POSIX only)
+ *
+ * A table file is a header followed by the table's elements, exactly as they
+ * are laid out in memory.  Header fields are little-endian:
+ *
+ * | offset | size | field                                       |
+ * |--------|------|---------------------------------------------|
+ * | 0      | 8    | magic, "RANKCPP" and a NUL                  |
+ * | 8      | 4    | format version                              |
+ * | 12     | 4    | 0x01020304 in the writer's byte order       |
+ * | 16     | 1    | TableKind                                   |
+ * | 17     | 1    | ElementType                                 |
+ * | 18     | 2    | bytes per element                           |
+ * | 20     | 4    | precision bits (0 if unknown or not mapped) |
+ * | 24     | 4    | vector count                                |
+ * | 28     | 4    | reserved, 0                                 |
+ * | 32     | 8    | payload offset                              |
+ * | 40     | 8    | payload size in bytes                       |
+ * | 48     | 8n   | start and bit count of each vector's span   |
+ *
+ * The payload starts at the next multiple of PayloadAlignment, so a mapped
+ * file can be used in place.
+ */
+
+namespace rankcpp {
+
+constexpr std::uint32_t const TableFormatVersion = 1;
+constexpr std::size_t const PayloadAlignment = 64;
+
+enum class TableKind : std::uint8_t { Scores = 1, Weights = 2 };
+
+enum class ElementType : std::uint8_t {
+  Float32 = 1,
+  Float64 = 2,
+  UInt8 = 3,
+  UInt16 = 4,
+  UInt32 = 5,
+  UInt64 = 6
+};
+
+template <typename T> constexpr auto elementTypeOf() noexcept -> ElementType {
+  static_assert(std::is_same_v<T, float> || std::is_same_v<T, double> ||
+                    std::is_same_v<T, std::uint8_t> ||
+                    std::is_same_v<T, std::uint16_t> ||
+                    std::is_same_v<T, std::uint32_t> ||
+                    std::is_same_v<T, std::uint64_t>,
+                "tables of this element type cannot be serialized");
+  if constexpr (std::is_same_v<T, float>) {
+    return ElementType::Float32;
+  } else if constexpr (std::is_same_v<T, double>) {
+    return ElementType::Float64;
+  } else if constexpr (std::is_same_v<T, std::uint8_t>) {
+    return ElementType::UInt8;
+  } else if constexpr (std::is_same_v<T, std::uint16_t>) {
+    return ElementType::UInt16;
+  } else if constexpr (std::is_same_v<T, std::uint32_t>) {
+    return ElementType::UInt32;
+  } else {
+    return ElementType::UInt64;
+  }
+}
+
+struct TableHeader {
+  TableKind kind;
+  ElementType elementType;
+  std::uint32_t precisionBits;
+  Dimensions dims;
+  std::uint64_t payloadOffset;
+  std::uint64_t payloadBytes;
+};
+
+namespace detail {
+
+constexpr std::array<char, 8> const TableMagic = {'R', 'A', 'N', 'K',
+                                                  'C', 'P', 'P', '\0'};
+constexpr std::uint32_t const ByteOrderMark = 0x01020304;
+constexpr std::size_t const FixedHeaderBytes = 48;
+
+inline auto elementBytes(ElementType type) -> std::size_t {
+  switch (type) {
+  case ElementType::UInt8:
+    return 1;
+  case ElementType::UInt16:
+    return 2;
+  case ElementType::Float32:
+  case ElementType::UInt32:
+    return 4;
+  case ElementType::Float64:
+  case ElementType::UInt64:
+    return 8;
+  }
+  throw std::runtime_error("unknown table element type " +
+                           std::to_string(static_cast<int>(type)));
+}
+
+inline void appendLe(std::string &out, std::uint64_t value,
+                     std::size_t byteCount) {
+  for (std::size_t b = 0; b < byteCount; ++b) {
+    out.push_back(static_cast<char>((value >> (8 * b)) & 0xffU));
+  }
+}
+
+template <class DimensionsType>
+void writeTableFile(std::ostream &os, TableKind kind, ElementType elementType,
+                    std::uint32_t precisionBits, DimensionsType const &dims,
+                    void const *payload, std::size_t payloadBytes) {
+  auto const &spans = dims.asSpans();
+  auto const headerBytes = FixedHeaderBytes + 8 * spans.size();
+  auto const payloadOffset =
+      (headerBytes + PayloadAlignment - 1) / PayloadAlignment *
+      PayloadAlignment;
+
+  std::string header(std::cbegin(TableMagic), std::cend(TableMagic));
+  appendLe(header, TableFormatVersion, 4);
+  std::array<char, 4> mark{};
+  std::memcpy(mark.data(), &ByteOrderMark, mark.size());
+  header.append(mark.data(), mark.size());
+  appendLe(header, static_cast<std::uint8_t>(kind), 1);
+  appendLe(header, static_cast<std::uint8_t>(elementType), 1);
+  appendLe(header, elementBytes(elementType), 2);
+  appendLe(header, precisionBits, 4);
+  appendLe(header, spans.size(), 4);
+  appendLe(header, 0, 4);
+  appendLe(header, payloadOffset, 8);
+  appendLe(header, payloadBytes, 8);
+  for (auto const &span : spans) {
+    appendLe(header, span.start(), 4);
+    appendLe(header, span.count(), 4);
+  }
+  header.resize(payloadOffset, '\0');
+
+  os.write(header.data(), static_cast<std::streamsize>(header.size()));
+  os.write(static_cast<char const *>(payload),
+           static_cast<std::streamsize>(payloadBytes));
+}
+
+} /* namespace detail */
+
+template <typename T, class DimensionsType, class StorageType>
+void writeTable(std::ostream &os,
+                ScoresTable<T, DimensionsType, StorageType> const &table) {
+  auto const &scores = table.allScores();
+  detail::writeTableFile(os, TableKind::Scores, elementTypeOf<T>(), 0,
+                         table.dimensions(), scores.data(),
+                         scores.size() * sizeof(T));
+}
+
+// precisionBits records the precision the table was mapped at, if known
+template <typename T, class DimensionsType, class StorageType>
+void writeTable(std::ostream &os,
+                WeightTable<T, DimensionsType, StorageType> const &table,
+                std::uint32_t precisionBits = 0) {
+  auto const &weights = table.allWeights();
+  detail::writeTableFile(os, TableKind::Weights, elementTypeOf<T>(),
+                         precisionBits, table.dimensions(), weights.data(),
+                         weights.size() * sizeof(T));
+}
+
+/**
+ * Parses and checks the header at the start of bytes, which must hold the
+ * whole file.  Throws std::runtime_error if bytes is not a table file this
+ * version can read.
+ */
+inline auto readTableHeader(gsl::span<std::uint8_t const> bytes)
+    -> TableHeader {
+  auto const *const data = bytes.data();
+  auto const field = [&data](std::size_t offset, std::size_t byteCount) {
+    return loadLe64(data + offset, byteCount);
+  };
+
+  if (bytes.size() < detail::FixedHeaderBytes ||
+      !std::equal(std::cbegin(detail::TableMagic),
+                  std::cend(detail::TableMagic),
+                  reinterpret_cast<char const *>(data))) {
+    throw std::runtime_error("not a rankcpp table file");
+  }
+  if (field(8, 4) != TableFormatVersion) {
+    throw std::runtime_error("unsupported table format version " +
+                             std::to_string(field(8, 4)));
+  }
+  std::uint32_t mark{0};
+  std::memcpy(&mark, data + 12, sizeof(mark));
+  if (mark != detail::ByteOrderMark) {
+    throw std::runtime_error("table file was written with another byte order");
+  }
+
+  auto const kind = static_cast<TableKind>(field(16, 1));
+  if (kind != TableKind::Scores && kind != TableKind::Weights) {
+    throw std::runtime_error("unknown table kind " +
+                             std::to_string(field(16, 1)));
+  }
+  auto const elementType = static_cast<ElementType>(field(17, 1));
+  auto const elementBytes = detail::elementBytes(elementType);
+  if (field(18, 2) != elementBytes) {
+    throw std::runtime_error("element size does not match element type");
+  }
+
+  auto const vectorCount = field(24, 4);
+  if (vectorCount == 0 ||
+      bytes.size() < detail::FixedHeaderBytes + 8 * vectorCount) {
+    throw std::runtime_error("table file is truncated");
+  }
+  std::vector<std::uint32_t> widths;
+  widths.reserve(vectorCount);
+  std::uint64_t expectedStart = 0;
+  // summed here with overflow checks, as Dimensions::scoresCount would wrap
+  auto const maxElements =
+      std::numeric_limits<std::size_t>::max() / elementBytes;
+  std::size_t elementCount = 0;
+  for (std::size_t vi = 0; vi < vectorCount; ++vi) {
+    auto const start = field(detail::FixedHeaderBytes + 8 * vi, 4);
+    auto const count = field(detail::FixedHeaderBytes + 8 * vi + 4, 4);
+    // Dimensions only describes contiguous spans
+    if (start != expectedStart || count == 0 ||
+        count >= std::numeric_limits<std::size_t>::digits) {
+      throw std::runtime_error("vector " + std::to_string(vi) +
+                               " has an invalid span");
+    }
+    auto const valueCount = std::size_t{1} << count;
+    if (valueCount > maxElements - elementCount) {
+      throw std::runtime_error("table dimensions are too large");
+    }
+    widths.push_back(static_cast<std::uint32_t>(count));
+    expectedStart += count;
+    elementCount += valueCount;
+  }
+  Dimensions dims(widths);
+
+  auto const payloadOffset = field(32, 8);
+  auto const payloadBytes = field(40, 8);
+  if (payloadOffset % PayloadAlignment != 0 ||
+      payloadBytes != elementCount * elementBytes) {
+    throw std::runtime_error("table payload does not match its dimensions");
+  }
+  if (payloadOffset > bytes.size() ||
+      bytes.size() - payloadOffset < payloadBytes) {
+    throw std::runtime_error("table file is truncated");
+  }
+
+  return {kind,
+          elementType,
+          static_cast<std::uint32_t>(field(20, 4)),
+          std::move(dims),
+          payloadOffset,
+          payloadBytes};
+}
+
+/**
+ * A table file mapped into memory.  payload() and the views point straight
+ * into the mapping, so opening a table costs a few system calls however large
+ * it is, and processes opening the same file share the page cache's copy of
+ * it.  The views must not outlive the MappedTable.
+ */
+class MappedTable {
+public:
+  explicit MappedTable(std::string const &path)
+      : file_(path), header_(readTableHeader(file_.asBytes())) {}
+
+  auto header() const noexcept -> TableHeader const & { return header_; }
+
+  auto dimensions() const noexcept -> Dimensions const & {
+    return header_.dims;
+  }
+
+  // throws std::invalid_argument if the file does not hold elements of type T
+  template <typename T> auto payload() const -> gsl::span<T const> {
+    if (header_.elementType != elementTypeOf<T>()) {
+      throw std::invalid_argument(
+          "table file does not hold elements of the requested type");
+    }
+    auto const *const first = file_.asBytes().data() + header_.payloadOffset;
+    return {reinterpret_cast<T const *>(first),
+            static_cast<std::size_t>(header_.payloadBytes / sizeof(T))};
+  }
+
+  template <typename T> auto scoresView() const -> ConstScoresTableView<T> {
+    requireKind(TableKind::Scores);
+    return {header_.dims, payload<T>()};
+  }
+
+  template <typename T> auto weightsView() const -> ConstWeightTableView<T> {
+    requireKind(TableKind::Weights);
+    return {header_.dims, payload<T>()};
+  }
+
+  // copies the payload into an owning table
+  template <typename T> auto toScoresTable() const -> ScoresTable<T> {
+    requireKind(TableKind::Scores);
+    auto const elements = payload<T>();
+    return {header_.dims, std::vector<T>(elements.begin(), elements.end())};
+  }
+
+  template <typename T> auto toWeightTable() const -> WeightTable<T> {
+    requireKind(TableKind::Weights);
+    auto const elements = payload<T>();
+    return {header_.dims, std::vector<T>(elements.begin(), elements.end())};
+  }
+
+private:
+  MappedFile file_;
+  TableHeader header_;
+
+  void requireKind(TableKind kind) const {
+    if (header_.kind != kind) {
+      throw std::invalid_argument(kind == TableKind::Scores
+                                      ? "table file does not hold scores"
+                                      : "table file does not hold weights");
+    }
+  }
+};
+
+} /* namespace rankcpp */
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/ScoresTable.hpp>
+#include <rankcpp/utils/Numeric.hpp>
+#include <rankcpp/utils/Parallel.hpp>
+#include <rankcpp/utils/Random.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** \file
+ * \brief Generating the scores of simulated side-channel attacks
+ *
+ */
+
+namespace rankcpp {
+
+/**
+ * Each trace leaks the Hamming weight of a random plaintext XORed with the
+ * subkey of every distinguishing vector, plus Gaussian noise with standard
+ * deviation noise.  The same seed always gives the same key and scores, for
+ * any threadCount (0 uses every hardware thread).  The key and plaintexts are
+ * derived from Xoshiro256 directly, so only the noise, through std::log and
+ * std::cos, can differ in the last bits between math libraries.
+ */
+struct AttackParameters {
+  double noise{1.0};
+  std::size_t traceCount{100};
+  std::uint64_t seed{0};
+  std::size_t threadCount{0};
+};
+
+template <std::uint32_t KeyLenBits, typename T, class DimensionsType>
+struct SimulatedAttack {
+  Key<KeyLenBits> key;
+  ScoresTable<T, DimensionsType> scores;
+};
+
+namespace detail {
+
+// the Gaussian template log-likelihood (up to a constant) of every subkey
+// hypothesis for one distinguishing vector, summed over the traces
+template <typename T>
+void simulateVector(std::uint32_t widthBits, std::size_t subkey,
+                    AttackParameters const &params, Xoshiro256 &rng,
+                    T *likelihoods) {
+  auto const subkeyCount = std::size_t{1} << widthBits;
+  // subkeyCount is a power of two, so masking a draw keeps it uniform
+  auto const plaintextMask = static_cast<std::uint64_t>(subkeyCount - 1);
+  auto const scale = T{-1} / (T{2} * static_cast<T>(params.noise) *
+                              static_cast<T>(params.noise));
+
+  std::vector<std::uint32_t> hammingWeights(subkeyCount);
+  for (std::size_t value = 0; value < subkeyCount; ++value) {
+    hammingWeights[value] =
+        static_cast<std::uint32_t>(std::bitset<64>(value).count());
+  }
+  std::vector<T> penalties(widthBits + 1);
+
+  for (std::size_t trace = 0; trace < params.traceCount; ++trace) {
+    auto const plaintext = static_cast<std::size_t>(rng() & plaintextMask);
+    auto const noise = static_cast<T>(params.noise * standardNormal(rng));
+    auto const leakage =
+        static_cast<T>(hammingWeights[plaintext ^ subkey]) + noise;
+
+    // a hypothesis' likelihood only depends on its predicted Hamming weight
+    for (std::uint32_t weight = 0; weight <= widthBits; ++weight) {
+      auto const error = leakage - static_cast<T>(weight);
+      penalties[weight] = scale * error * error;
+    }
+    for (std::size_t hypothesis = 0; hypothesis < subkeyCount; ++hypothesis) {
+      likelihoods[hypothesis] +=
+          penalties[hammingWeights[plaintext ^ hypothesis]];
+    }
+  }
+}
+
+// built from the raw bytes of each draw, unlike randomKey, so the key does
+// not depend on the standard library
+template <std::uint32_t KeyLenBits>
+auto simulatedKey(Xoshiro256 &rng) -> Key<KeyLenBits> {
+  using ByteType = typename Key<KeyLenBits>::ByteType;
+  std::array<ByteType, Key<KeyLenBits>::ByteCount> bytes{};
+  for (std::size_t bi = 0; bi < bytes.size(); bi += 8) {
+    auto word = rng();
+    for (auto bj = bi; bj < std::min(bi + 8, bytes.size()); ++bj) {
+      bytes[bj] = static_cast<ByteType>(word & 0xffU);
+      word >>= 8U;
+    }
+  }
+  return Key<KeyLenBits>(bytes);
+}
+
+} /* namespace detail */
+
+/**
+ * Draws a uniformly random key and attacks it as described by params.  The
+ * scores are -log2 of the posterior probability of each subkey, and so can be
+ * handed directly to mapToWeight.
+ */
+template <std::uint32_t KeyLenBits, typename T = double,
+          class DimensionsType = Dimensions>
+auto simulateAttack(DimensionsType const &dims, AttackParameters const &params)
+    -> SimulatedAttack<KeyLenBits, T, DimensionsType> {
+  if (dims.keyLengthBits() != KeyLenBits) {
+    throw std::invalid_argument(
+        "dimensions describe a " + std::to_string(dims.keyLengthBits()) +
+        "-bit key, not a " + std::to_string(KeyLenBits) + "-bit key");
+  }
+  if (!(params.noise > 0.0)) {
+    throw std::invalid_argument("noise must be > 0");
+  }
+
+  // stream 0 draws the key, stream i + 1 the traces of vector i
+  Xoshiro256 keyRng(deriveSeed(params.seed, 0));
+  auto const key = detail::simulatedKey<KeyLenBits>(keyRng);
+
+  ScoresTable<T, DimensionsType> scores(dims);
+  auto &allScores = scores.allScores();
+  auto const &subkeys = dims.asSpans();
+
+  parallelFor(dims.vectorCount(), params.threadCount,
+              [&](std::size_t vectorIndex, std::size_t /*unused*/) {
+                Xoshiro256 rng(deriveSeed(params.seed, vectorIndex + 1));
+                auto const offset = dims.scoresBeforeCount(vectorIndex);
+                auto *const likelihoods = allScores.data() + offset;
+                detail::simulateVector(
+                    dims.vectorWidthBits(vectorIndex),
+                    key.template subkeyValue<std::size_t>(subkeys[vectorIndex]),
+                    params, rng, likelihoods);
+                logLikelihoodsToScores(
+                    likelihoods,
+                    likelihoods + dims.subkeyCount(vectorIndex), likelihoods);
+              });
+
+  return {key, std::move(scores)};
+}
+
+} /* namespace rankcpp */
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/** \file
+ * \brief Finding the key at a given index of the rank order
+ *
+ * The keys with a weight below maxWeight are ordered by weight, and keys of
+ * the same weight by their subkey indices, vector 0 first.  Index 0 is then
+ * the most likely key and index rank - 1 the last key counted by rank.
+ */
+
+namespace rankcpp {
+
+/**
+ * The rank DP kept for every suffix of the vectors: below(vi, w) is the
+ * number of keys over vectors vi onwards with a weight below w, for w up to
+ * maxWeight.  This is (vectorCount + 1) * (maxWeight + 1) RankTypes, built in
+ * the time rank takes.
+ */
+template <typename RankType> class SuffixCounts {
+public:
+  template <typename WeightType, class DimensionsType, class StorageType>
+  SuffixCounts(
+      WeightType maxWeight,
+      WeightTable<WeightType, DimensionsType, StorageType> const &weights)
+      : weightCount_(static_cast<std::size_t>(maxWeight) + 1),
+        vectorCount_(weights.dimensions().vectorCount()),
+        counts_((vectorCount_ + 1) * weightCount_, RankType{0}) {
+    if (maxWeight == 0) {
+      throw std::invalid_argument("The max weight ranked up to must > 0");
+    }
+
+    // no vectors: only the empty key, of weight 0
+    std::fill(row(vectorCount_) + 1, row(vectorCount_) + weightCount_,
+              RankType{1});
+    auto const &dims = weights.dimensions();
+    for (auto vi = vectorCount_; vi-- > 0;) {
+      auto *const curr = row(vi);
+      auto const *const prev = row(vi + 1);
+      for (std::size_t ski = 0; ski < dims.subkeyCount(vi); ++ski) {
+        auto const weight = static_cast<std::size_t>(weights(vi, ski));
+        if (weight < weightCount_) {
+          detail::addRanks(curr + weight, prev, weightCount_ - weight);
+        }
+      }
+    }
+  }
+
+  auto maxWeight() const noexcept -> std::size_t { return weightCount_ - 1; }
+
+  auto vectorCount() const noexcept -> std::size_t { return vectorCount_; }
+
+  // the number of keys with a weight below maxWeight, as rank returns
+  auto keyCount() const noexcept -> RankType const & {
+    return row(0)[weightCount_ - 1];
+  }
+
+  auto below(std::size_t vectorIndex, std::size_t weight) const
+      -> RankType const & {
+    if (vectorIndex > vectorCount_ || weight >= weightCount_) {
+      throw std::out_of_range("No suffix count for that vector or weight");
+    }
+    return row(vectorIndex)[weight];
+  }
+
+  // the number of keys over vectors vectorIndex onwards weighing exactly weight
+  auto exactly(std::size_t vectorIndex, std::size_t weight) const -> RankType {
+    return below(vectorIndex, weight + 1) - below(vectorIndex, weight);
+  }
+
+private:
+  auto row(std::size_t vectorIndex) noexcept -> RankType * {
+    return counts_.data() + vectorIndex * weightCount_;
+  }
+
+  auto row(std::size_t vectorIndex) const noexcept -> RankType const * {
+    return counts_.data() + vectorIndex * weightCount_;
+  }
+
+  std::size_t weightCount_;
+  std::size_t vectorCount_;
+  std::vector<RankType> counts_;
+};
+
+/**
+ * The key at index in the rank order, in O(vectorCount * subkeyCount) steps.
+ * counts must have been built from weights.  Throws std::out_of_range if
+ * index is not below counts.keyCount().
+ */
+template <std::uint32_t KeyLenBits, typename RankType, typename WeightType,
+          class DimensionsType, class StorageType>
+auto unrank(RankType index,
+            WeightTable<WeightType, DimensionsType, StorageType> const &weights,
+            SuffixCounts<RankType> const &counts) -> Key<KeyLenBits> {
+  auto const &dims = weights.dimensions();
+  if (dims.keyLengthBits() > KeyLenBits) {
+    throw std::invalid_argument("The key is shorter than the dimensions");
+  }
+  if (dims.vectorCount() != counts.vectorCount()) {
+    throw std::invalid_argument("The counts are for a different table");
+  }
+  if (!(index < counts.keyCount())) {
+    throw std::out_of_range("The index is beyond the last key ranked");
+  }
+
+  // the weight of the key: the keys lighter than it come before it
+  std::size_t remaining = 0;
+  auto high = counts.maxWeight() - 1;
+  while (remaining < high) {
+    auto const middle = remaining + (high - remaining) / 2;
+    if (index < counts.below(0, middle + 1)) {
+      high = middle;
+    } else {
+      remaining = middle + 1;
+    }
+  }
+  index -= counts.below(0, remaining);
+
+  // each subkey, in index order, is followed by a block of the keys over the
+  // later vectors that make up the remaining weight
+  Key<KeyLenBits> key{};
+  auto const &spans = dims.asSpans();
+  for (std::size_t vi = 0; vi < dims.vectorCount(); ++vi) {
+    for (std::size_t ski = 0; ski < dims.subkeyCount(vi); ++ski) {
+      auto const weight = static_cast<std::size_t>(weights(vi, ski));
+      if (weight > remaining) {
+        continue;
+      }
+      auto const block = counts.exactly(vi + 1, remaining - weight);
+      if (index < block) {
+        key.setSubkeyValue(spans[vi], ski);
+        remaining -= weight;
+        break;
+      }
+      index -= block;
+    }
+  }
+  return key;
+}
+
+} /* namespace rankcpp */
@@ -3,6 +3,8 @@
 #include <rankcpp/Dimensions.hpp>
 #include <rankcpp/Key.hpp>
 #include <rankcpp/ScoresTable.hpp>
+#include <rankcpp/utils/Bits.hpp>
+#include <rankcpp/utils/Parallel.hpp>
 
 #include <gsl/span>
 
@@ -10,17 +12,45 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <initializer_list>
 #include <numeric>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace rankcpp {
 
-template <typename T, class DimensionsType = Dimensions> class WeightTable {
+namespace detail {
+
+/**
+ * Where one distinguishing vector's subkey lies within a key: the word loaded
+ * from byteCount bytes at byteOffset, shifted right by shift and masked, is
+ * the subkey value, and tableOffset is where its weights start.
+ */
+struct SubkeyLookup {
+  std::uint32_t byteOffset;
+  std::uint32_t byteCount;
+  std::uint32_t shift;
+  std::uint64_t mask;
+  std::size_t tableOffset;
+};
+
+} /* namespace detail */
+
+/**
+ * The weights of every subkey of every distinguishing vector, stored in
+ * StorageType.  The default std::vector owns them; a gsl::span instead views
+ * weights owned elsewhere (see WeightTableView), and can be used wherever an
+ * owning table can, other than to resize or reallocate it.
+ */
+template <typename T, class DimensionsType = Dimensions,
+          class StorageType = std::vector<T>>
+class WeightTable {
 public:
   // TODO doesn't have to be unsigned
   static_assert(std::is_integral_v<T> && std::is_unsigned_v<T>,
@@ -31,8 +61,15 @@ public:
   explicit WeightTable(DimensionsType dims)
       : dims_(dims), weights_(dims.scoresCount()) {}
 
-  WeightTable(DimensionsType dims, std::vector<T> weights)
-      : dims_(std::move(dims)), weights_(std::move(weights)) {}
+  WeightTable(DimensionsType dims, StorageType weights)
+      : dims_(std::move(dims)), weights_(std::move(weights)) {
+    if (weights_.size() != dims_.scoresCount()) {
+      throw std::length_error("weights need to be of length " +
+                              std::to_string(dims_.scoresCount()) +
+                              " but are of length " +
+                              std::to_string(weights_.size()));
+    }
+  }
 
   WeightTable(DimensionsType dims, std::initializer_list<T> const &list)
       : dims_(dims), weights_(dims.scoresCount()) {
@@ -46,11 +83,11 @@ public:
   }
 
   auto weight(std::size_t vectorIndex, std::size_t subkeyIndex) const -> T {
-    return weights_.at(dims_.scoresBeforeCount(vectorIndex) + subkeyIndex);
+    return weights_[checkedIndex(vectorIndex, subkeyIndex)];
   }
 
   auto weight(std::size_t vectorIndex, std::size_t subkeyIndex) -> T & {
-    return weights_.at(dims_.scoresBeforeCount(vectorIndex) + subkeyIndex);
+    return weights_[checkedIndex(vectorIndex, subkeyIndex)];
   }
 
   auto operator()(std::size_t vectorIndex, std::size_t subkeyIndex) noexcept
@@ -119,6 +156,10 @@ public:
 
   template <std::uint32_t KeyLenBits>
   auto weightForKey(Key<KeyLenBits> const &key) const -> T {
+    if constexpr (fitsFixedShape<KeyLenBits>()) {
+      return fixedWeightForKey(
+          key, std::make_index_sequence<DimensionsType::FixedVectorCount>{});
+    }
     auto indexedSubkeys =
         ranges::views::zip(dims_.vectorRange(), dims_.asSpans());
     return std::accumulate(std::cbegin(indexedSubkeys),
@@ -131,17 +172,138 @@ public:
                            });
   }
 
+  /**
+   * Writes the weight of keys[i] to weights[i].  The position of every subkey
+   * is worked out once for the whole batch, and each subkey is then read with
+   * a single word load, a shift and a mask.  Blocks of keys are shared across
+   * threadCount threads (0 uses every hardware thread).
+   */
+  template <std::uint32_t KeyLenBits>
+  void weightsForKeys(gsl::span<Key<KeyLenBits> const> keys,
+                      gsl::span<T> weights, std::size_t threadCount = 0) const {
+    if (keys.size() != weights.size()) {
+      throw std::length_error("need space for " + std::to_string(keys.size()) +
+                              " weights but have " +
+                              std::to_string(weights.size()));
+    }
+
+    std::size_t const blockSize = 4096;
+    auto const blockCount = (keys.size() + blockSize - 1) / blockSize;
+    if constexpr (fitsFixedShape<KeyLenBits>()) {
+      parallelFor(blockCount, threadCount,
+                  [&](std::size_t blockIndex, std::size_t /*unused*/) {
+                    auto const first = blockIndex * blockSize;
+                    auto const last = std::min(first + blockSize, keys.size());
+                    for (auto ki = first; ki < last; ++ki) {
+                      weights[ki] = fixedWeightForKey(
+                          keys[ki],
+                          std::make_index_sequence<
+                              DimensionsType::FixedVectorCount>{});
+                    }
+                  });
+      return;
+    }
+
+    auto const lookups = subkeyLookups(Key<KeyLenBits>::ByteCount);
+    parallelFor(blockCount, threadCount,
+                [&](std::size_t blockIndex, std::size_t /*unused*/) {
+                  auto const first = blockIndex * blockSize;
+                  auto const last = std::min(first + blockSize, keys.size());
+                  for (auto ki = first; ki < last; ++ki) {
+                    auto const *const bytes = keys[ki].asBytes().data();
+                    T sum{0};
+                    for (auto const &lookup : lookups) {
+                      auto const word =
+                          loadLe64(bytes + lookup.byteOffset, lookup.byteCount);
+                      auto const subkeyValue =
+                          static_cast<std::size_t>((word >> lookup.shift) &
+                                                   lookup.mask);
+                      sum += weights_[lookup.tableOffset + subkeyValue];
+                    }
+                    weights[ki] = sum;
+                  }
+                });
+  }
+
+  template <std::uint32_t KeyLenBits>
+  auto weightsForKeys(gsl::span<Key<KeyLenBits> const> keys,
+                      std::size_t threadCount = 0) const -> std::vector<T> {
+    std::vector<T> weights(keys.size());
+    weightsForKeys(keys, gsl::span<T>(weights), threadCount);
+    return weights;
+  }
+
   auto dimensions() const -> DimensionsType const & { return dims_; }
 
-  auto allWeights() noexcept -> std::vector<T> & { return weights_; };
+  auto allWeights() noexcept -> StorageType & { return weights_; };
 
-  auto allWeights() const noexcept -> std::vector<T> const & {
-    return weights_;
-  };
+  auto allWeights() const noexcept -> StorageType const & { return weights_; };
 
 private:
   DimensionsType const dims_;
-  std::vector<T> weights_;
+  StorageType weights_;
+
+  auto checkedIndex(std::size_t vectorIndex, std::size_t subkeyIndex) const
+      -> std::size_t {
+    auto const index = dims_.scoresBeforeCount(vectorIndex) + subkeyIndex;
+    if (index >= weights_.size()) {
+      throw std::out_of_range("weight index " + std::to_string(index) +
+                              " is out of range");
+    }
+    return index;
+  }
+
+  // whether keys of KeyLenBits bits can be weighted with a FixedDimensions
+  // shape known at compile time
+  template <std::uint32_t KeyLenBits>
+  static constexpr auto fitsFixedShape() noexcept -> bool {
+    if constexpr (IsFixedDimensionsV<DimensionsType>) {
+      return DimensionsType::FixedVectorCount *
+                 DimensionsType::FixedVectorWidthBits <=
+             Key<KeyLenBits>::ByteCount * 8;
+    } else {
+      return false;
+    }
+  }
+
+  // weightForKey with every subkey position and table offset a constant
+  template <std::uint32_t KeyLenBits, std::size_t... Indices>
+  auto fixedWeightForKey(Key<KeyLenBits> const &key,
+                         std::index_sequence<Indices...> /*unused*/) const
+      noexcept -> T {
+    constexpr auto const width = DimensionsType::FixedVectorWidthBits;
+    constexpr std::size_t const subkeyCount = std::size_t{1} << width;
+    return static_cast<T>(
+        (T{0} + ... +
+         weights_[Indices * subkeyCount +
+                  key.template subkeyValue<Indices * width, width>()]));
+  }
+
+  auto subkeyLookups(std::size_t keyByteCount) const
+      -> std::vector<detail::SubkeyLookup> {
+    std::vector<detail::SubkeyLookup> lookups;
+    lookups.reserve(dims_.vectorCount());
+    for (std::size_t vectorIndex : dims_.vectorRange()) {
+      auto const &subkey = dims_.asSpans()[vectorIndex];
+      auto const byteOffset = subkey.start() / 8;
+      auto const shift = subkey.start() % 8;
+      if (shift + subkey.count() > 64) {
+        throw std::out_of_range("subkey " + std::to_string(vectorIndex) +
+                                " does not fit in a 64-bit word");
+      }
+      if (byteOffset >= keyByteCount) {
+        throw std::out_of_range("subkey " + std::to_string(vectorIndex) +
+                                " lies beyond the end of the key");
+      }
+      auto const byteCount =
+          std::min<std::size_t>({(shift + subkey.count() + 7) / 8,
+                                 keyByteCount - byteOffset, std::size_t{8}});
+      lookups.push_back({byteOffset, static_cast<std::uint32_t>(byteCount),
+                         shift, lowBitsMask(subkey.count()),
+                         dims_.scoresBeforeCount(vectorIndex)});
+    }
+    return lookups;
+  }
 
   template <typename SortType> void sortEachSubkey() {
     for (std::size_t vectorIndex : dims_.vectorRange()) {
@@ -156,11 +318,21 @@ private:
   }
 };
 
-// TODO needs unit tests
-template <typename ScoresType, typename WeightType, typename DimensionsType>
-auto mapToWeight(ScoresTable<ScoresType, DimensionsType> const &table,
-                 std::uint32_t precisionBits)
-    -> WeightTable<WeightType, DimensionsType> {
+// a WeightTable over weights owned elsewhere
+template <typename T, class DimensionsType = Dimensions>
+using WeightTableView = WeightTable<T, DimensionsType, gsl::span<T>>;
+
+// a WeightTable over read-only weights, such as those of a mapped file
+template <typename T, class DimensionsType = Dimensions>
+using ConstWeightTableView =
+    WeightTable<T, DimensionsType, gsl::span<T const>>;
+
+namespace detail {
+
+template <typename ScoresType, typename DimensionsType, class StorageType>
+auto weightMultiplier(
+    ScoresTable<ScoresType, DimensionsType, StorageType> const &table,
+    std::uint32_t precisionBits) -> ScoresType {
   if (precisionBits < 2) {
     throw std::invalid_argument("Cannot run mapToWeight at less than"
                                 " 2 bits of precision");
@@ -174,10 +346,22 @@ auto mapToWeight(ScoresTable<ScoresType, DimensionsType> const &table,
   if (std::isinf(alpha)) {
     throw std::logic_error("max score is 0.0; cannot apply mapToWeight");
   }
-  auto const multiplier =
-      std::pow(2.0, static_cast<ScoresType>(precisionBits) - alpha);
+  return std::pow(2.0, static_cast<ScoresType>(precisionBits) - alpha);
+}
+
+} /* namespace detail */
+
+// TODO needs unit tests
+template <typename ScoresType, typename WeightType, typename DimensionsType,
+          class StorageType>
+auto mapToWeight(
+    ScoresTable<ScoresType, DimensionsType, StorageType> const &table,
+    std::uint32_t precisionBits)
+    -> WeightTable<WeightType, DimensionsType> {
+  auto const multiplier = detail::weightMultiplier(table, precisionBits);
 
   // go back through the vectors, find and set the mapped weights
+  auto const &scores = table.allScores();
   WeightTable<WeightType, DimensionsType> weights(table.dimensions());
   std::transform(std::cbegin(scores), std::cend(scores),
                  std::begin(weights.allWeights()),
@@ -191,4 +375,52 @@ auto mapToWeight(ScoresTable<ScoresType, DimensionsType> const &table,
   return weights;
 }
 
+/**
+ * The pair of tables produced by rounding every mapped score both down and up.
+ * Both tables are translated by the same amount, so the weight of any key
+ * under floor is never greater than its weight under ceil.
+ */
+template <typename WeightType, typename DimensionsType = Dimensions>
+struct WeightTableBounds {
+  WeightTable<WeightType, DimensionsType> floor;
+  WeightTable<WeightType, DimensionsType> ceil;
+};
+
+template <typename ScoresType, typename WeightType, typename DimensionsType,
+          class StorageType>
+auto mapToWeightBounds(
+    ScoresTable<ScoresType, DimensionsType, StorageType> const &table,
+    std::uint32_t precisionBits)
+    -> WeightTableBounds<WeightType, DimensionsType> {
+  auto const multiplier = detail::weightMultiplier(table, precisionBits);
+
+  auto const &scores = table.allScores();
+  WeightTable<WeightType, DimensionsType> floorTable(table.dimensions());
+  WeightTable<WeightType, DimensionsType> ceilTable(table.dimensions());
+  std::transform(std::cbegin(scores), std::cend(scores),
+                 std::begin(floorTable.allWeights()),
+                 [&multiplier](ScoresType const &score) {
+                   return static_cast<WeightType>(score * multiplier);
+                 });
+  std::transform(std::cbegin(scores), std::cend(scores),
+                 std::begin(ceilTable.allWeights()),
+                 [&multiplier](ScoresType const &score) {
+                   return static_cast<WeightType>(
+                       std::ceil(score * multiplier));
+                 });
+
+  // apply the shift that takes the floor table to a minimum of 1 to the ceil
+  // table too, otherwise the two tables are no longer comparable
+  auto const &floorWeights = floorTable.allWeights();
+  auto const &ceilWeights = ceilTable.allWeights();
+  auto const floorMin =
+      *std::min_element(std::cbegin(floorWeights), std::cend(floorWeights));
+  auto const ceilMin =
+      *std::min_element(std::cbegin(ceilWeights), std::cend(ceilWeights));
+  floorTable.rebase(1);
+  ceilTable.rebase(static_cast<WeightType>(ceilMin + 1 - floorMin));
+
+  return {std::move(floorTable), std::move(ceilTable)};
+}
+
 } /* namespace rankcpp */
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+/** \file
+ * \brief Word-wide access to little-endian byte strings
+ *
+ */
+
+namespace rankcpp {
+
+// the count (at most 8) bytes from bytes as a little-endian integer; compilers
+// turn the loop into a single load when count is known to be 8
+constexpr auto loadLe64(std::uint8_t const *bytes, std::size_t count) noexcept
+    -> std::uint64_t {
+  std::uint64_t value{0};
+  for (std::size_t b = 0; b < count; ++b) {
+    value |= std::uint64_t{bytes[b]} << (8 * b);
+  }
+  return value;
+}
+
+// a mask of the lowest bitCount bits, for any bitCount up to 64
+constexpr auto lowBitsMask(std::uint32_t bitCount) noexcept -> std::uint64_t {
+  return bitCount >= 64 ? ~std::uint64_t{0}
+                        : (std::uint64_t{1} << bitCount) - 1;
+}
+
+/**
+ * Bits [start, start + count) of the byteCount byte little-endian string at
+ * bytes, for count up to 64.  Reads only the bytes the bits lie in, so the
+ * bits must lie within the string.
+ */
+constexpr auto loadBitsLe(std::uint8_t const *bytes, std::size_t byteCount,
+                          std::uint32_t start, std::uint32_t count) noexcept
+    -> std::uint64_t {
+  auto const byteOffset = start / 8;
+  auto const shift = start % 8;
+  auto const wordBytes = std::min<std::size_t>(
+      {(shift + count + 7) / 8, byteCount - byteOffset, std::size_t{8}});
+  auto value = loadLe64(bytes + byteOffset, wordBytes) >> shift;
+  // an unaligned 58 to 64 bit span spills into a ninth byte
+  if (shift + count > 64) {
+    value |= std::uint64_t{bytes[byteOffset + 8]} << (64 - shift);
+  }
+  return value & lowBitsMask(count);
+}
+
+} /* namespace rankcpp */
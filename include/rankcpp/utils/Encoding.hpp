@@ -1,46 +1,126 @@
 #pragma once
 
+#include <rankcpp/utils/Bits.hpp>
+
 #include <gsl/span>
 
-#include <algorithm>
-#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <iterator>
 #include <stdexcept>
 #include <string>
-#include <vector>
+#include <string_view>
 
 namespace rankcpp {
 
-inline void hexToBytes(const std::string &s, gsl::span<std::uint8_t> bytes) {
-  if (((s.size() + 1) / 2) > bytes.size()) {
-    throw std::length_error("output span is too small");
+namespace detail {
+
+// the value of one hex digit, or -1 if c is not one
+constexpr auto hexDigitValue(char c) noexcept -> int {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
   }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
 
-  union {
-    std::uint64_t binary;
-    std::array<char, 8> byte;
-  } value{};
+constexpr std::uint64_t const EachByte = 0x0101010101010101ULL;
+constexpr std::uint64_t const HighBits = 0x8080808080808080ULL;
 
-  std::vector<std::uint8_t> out{};
-  out.reserve((s.size() + 1) / 2);
+// the high bit of every byte of word (each < 0x80) in [lo, hi]
+constexpr auto bytesInRange(std::uint64_t word, std::uint64_t lo,
+                            std::uint64_t hi) noexcept -> std::uint64_t {
+  auto const atLeastLo = word + EachByte * (0x80 - lo);
+  auto const aboveHi = word + EachByte * (0x7f - hi);
+  return atLeastLo & ~aboveHi & HighBits;
+}
+
+/**
+ * Decodes the 8 hex digits packed little-endian in chars into the 4 bytes
+ * they spell, eight digits at a time within one 64-bit word.  Returns false,
+ * leaving out untouched, if any character is not a hex digit.
+ */
+inline auto decodeHex8(std::uint64_t chars, std::uint8_t *out) noexcept
+    -> bool {
+  auto const isDigit = bytesInRange(chars, '0', '9');
+  auto const isLetter = bytesInRange(chars | (EachByte * 0x20), 'a', 'f');
+  if ((chars & HighBits) != 0 || (isDigit | isLetter) != HighBits) {
+    return false;
+  }
 
-  auto offset = s.size() % 16;
-  if (offset != 0u) {
-    value.binary = std::stoull(s.substr(0, offset), nullptr, 16);
+  // '0'-'9' keep their low nibble, 'a'-'f' and 'A'-'F' add 9 to theirs
+  auto const nibbles = (chars & (EachByte * 0x0f)) + (isLetter >> 7U) * 9;
+  // byte 2i becomes (digit 2i << 4) | digit 2i + 1, then the even bytes are
+  // gathered into the low half of the word
+  auto packed = ((nibbles << 4U) | (nibbles >> 8U)) & 0x00ff00ff00ff00ffULL;
+  packed = (packed | (packed >> 8U)) & 0x0000ffff0000ffffULL;
+  packed = (packed | (packed >> 16U)) & 0x00000000ffffffffULL;
+  for (std::size_t b = 0; b < 4; ++b) {
+    out[b] = static_cast<std::uint8_t>(packed >> (8 * b));
+  }
+  return true;
+}
+
+[[noreturn]] inline void throwBadHex(std::string_view s) {
+  throw std::invalid_argument("not a hex string: \"" + std::string(s) + "\"");
+}
 
-    for (auto index = (offset + 1) / 2; (index--) != 0u;) {
-      out.emplace_back(value.byte[index]);
+} /* namespace detail */
+
+/**
+ * Decodes s into its first (s.size() + 1) / 2 bytes.  An odd length string is
+ * read as if it had a leading '0'.  Nothing is allocated unless s is invalid.
+ */
+inline void hexToBytes(std::string_view s, gsl::span<std::uint8_t> bytes) {
+  if (((s.size() + 1) / 2) > bytes.size()) {
+    throw std::length_error("output span is too small");
+  }
+
+  auto const *chars = reinterpret_cast<std::uint8_t const *>(s.data());
+  std::size_t pos = 0;
+  auto *out = bytes.data();
+  if (s.size() % 2 != 0) {
+    auto const value = detail::hexDigitValue(s[0]);
+    if (value < 0) {
+      detail::throwBadHex(s);
     }
+    *out++ = static_cast<std::uint8_t>(value);
+    pos = 1;
   }
 
-  for (; offset < s.size(); offset += 16) {
-    value.binary = std::stoull(s.substr(offset, 16), nullptr, 16);
-    for (std::size_t index = 8; (index--) != 0u;) {
-      out.emplace_back(value.byte[index]);
+  for (; pos + 8 <= s.size(); pos += 8, out += 4) {
+    if (!detail::decodeHex8(loadLe64(chars + pos, 8), out)) {
+      detail::throwBadHex(s);
+    }
+  }
+  for (; pos < s.size(); pos += 2) {
+    auto const high = detail::hexDigitValue(s[pos]);
+    auto const low = detail::hexDigitValue(s[pos + 1]);
+    if (high < 0 || low < 0) {
+      detail::throwBadHex(s);
     }
+    *out++ = static_cast<std::uint8_t>((high << 4) | low);
+  }
+}
+
+// writes the 2 * bytes.size() lowercase hex digits of bytes to the front of
+// chars, without a terminator
+inline void bytesToHex(gsl::span<std::uint8_t const> bytes,
+                       gsl::span<char> chars) {
+  if (chars.size() < 2 * bytes.size()) {
+    throw std::length_error("output span is too small");
+  }
+
+  constexpr char const *digits = "0123456789abcdef";
+  auto *out = chars.data();
+  for (auto const byte : bytes) {
+    *out++ = digits[byte >> 4U];
+    *out++ = digits[byte & 0x0fU];
   }
-  std::copy(std::cbegin(out), std::cend(out), std::begin(bytes));
 }
 
 } /* namespace rankcpp */
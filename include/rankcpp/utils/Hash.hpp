@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/** \file
+ * \brief Hashing tables and buffers to recognise them later
+ *
+ */
+
+namespace rankcpp {
+
+/**
+ * The 64-bit FNV-1a hash, fed incrementally.  It is not cryptographic, only
+ * meant to tell apart tables and buffers that should not be mixed up.
+ */
+class Fnv1a {
+public:
+  constexpr Fnv1a() noexcept = default;
+
+  void addBytes(void const *data, std::size_t byteCount) noexcept {
+    auto const *const bytes = static_cast<std::uint8_t const *>(data);
+    for (std::size_t b = 0; b < byteCount; ++b) {
+      hash_ = (hash_ ^ bytes[b]) * Prime;
+    }
+  }
+
+  template <typename T> void add(T const &value) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "only trivially copyable values can be hashed as bytes");
+    addBytes(&value, sizeof(value));
+  }
+
+  constexpr auto value() const noexcept -> std::uint64_t { return hash_; }
+
+private:
+  static constexpr std::uint64_t const Prime = 0x00000100000001b3ULL;
+
+  std::uint64_t hash_{0xcbf29ce484222325ULL};
+};
+
+} /* namespace rankcpp */
@@ -0,0 +1,204 @@
+#pragma once
+
+#if defined(_WIN32)
+#error "rankcpp/utils/MappedFile.hpp needs POSIX open, mmap and madvise"
+#endif
+
+#include <gsl/span>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** \file
+ * \brief Memory mapping of whole files (POSIX only)
+ *
+ */
+
+namespace rankcpp {
+
+/**
+ * Maps a whole file read-only for as long as the object lives, so that key
+ * and table files can be parsed in place rather than read into a buffer.
+ * Throws std::system_error if the file cannot be opened or mapped.
+ */
+class MappedFile {
+public:
+  explicit MappedFile(std::string const &path) {
+    auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              "cannot open " + path);
+    }
+
+    struct stat status {};
+    if (::fstat(fd, &status) != 0) {
+      auto const error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(),
+                              "cannot stat " + path);
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+
+    // mmap rejects empty mappings, so an empty file is left unmapped
+    if (size_ > 0) {
+      auto *const address =
+          ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (address == MAP_FAILED) {
+        auto const error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(),
+                                "cannot map " + path);
+      }
+      data_ = static_cast<std::uint8_t const *>(address);
+      ::madvise(address, size_, MADV_SEQUENTIAL);
+    }
+    // the mapping stays valid once the descriptor is closed
+    ::close(fd);
+  }
+
+  MappedFile(MappedFile const &) = delete;
+  auto operator=(MappedFile const &) -> MappedFile & = delete;
+
+  MappedFile(MappedFile &&other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  auto operator=(MappedFile &&other) noexcept -> MappedFile & {
+    if (this != &other) {
+      unmap();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  ~MappedFile() { unmap(); }
+
+  auto size() const noexcept -> std::size_t { return size_; }
+
+  auto asBytes() const noexcept -> gsl::span<std::uint8_t const> {
+    return {data_, size_};
+  }
+
+  auto asText() const noexcept -> std::string_view {
+    return {reinterpret_cast<char const *>(data_), size_};
+  }
+
+private:
+  std::uint8_t const *data_{nullptr};
+  std::size_t size_{0};
+
+  void unmap() noexcept {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<std::uint8_t *>(data_), size_);
+    }
+  }
+};
+
+/**
+ * Creates (or truncates) a file of size bytes and maps it read-write and
+ * shared, so the mapping can hold arrays too large for memory: the kernel
+ * writes pages back to the file and evicts them as it needs to.  The file is
+ * left in place when the object is destroyed.
+ */
+class WritableMappedFile {
+public:
+  WritableMappedFile(std::string const &path, std::size_t size) : size_(size) {
+    auto const fd =
+        ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              "cannot create " + path);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+      auto const error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(),
+                              "cannot resize " + path);
+    }
+
+    if (size_ > 0) {
+      auto *const address = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE,
+                                   MAP_SHARED, fd, 0);
+      if (address == MAP_FAILED) {
+        auto const error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(),
+                                "cannot map " + path);
+      }
+      data_ = static_cast<std::uint8_t *>(address);
+    }
+    ::close(fd);
+  }
+
+  WritableMappedFile(WritableMappedFile const &) = delete;
+  auto operator=(WritableMappedFile const &) -> WritableMappedFile & = delete;
+
+  WritableMappedFile(WritableMappedFile &&other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  auto operator=(WritableMappedFile &&other) noexcept
+      -> WritableMappedFile & {
+    if (this != &other) {
+      unmap();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  ~WritableMappedFile() { unmap(); }
+
+  auto size() const noexcept -> std::size_t { return size_; }
+
+  auto data() const noexcept -> std::uint8_t * { return data_; }
+
+  // asks the kernel to start reading [offset, offset + length) in
+  void willNeed(std::size_t offset, std::size_t length) const noexcept {
+    advise(offset, length, MADV_WILLNEED);
+  }
+
+  // writes every dirty page back to the file
+  void flush() const {
+    if (data_ != nullptr && ::msync(data_, size_, MS_SYNC) != 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              "cannot write mapped file back");
+    }
+  }
+
+private:
+  std::uint8_t *data_{nullptr};
+  std::size_t size_{0};
+
+  void advise(std::size_t offset, std::size_t length,
+              int advice) const noexcept {
+    if (data_ == nullptr || offset >= size_) {
+      return;
+    }
+    // madvise needs a page aligned start
+    auto const pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    auto const start = offset / pageSize * pageSize;
+    auto const end = std::min(size_, offset + length);
+    ::madvise(data_ + start, end - start, advice);
+  }
+
+  void unmap() noexcept {
+    if (data_ != nullptr) {
+      ::munmap(data_, size_);
+    }
+  }
+};
+
+} /* namespace rankcpp */
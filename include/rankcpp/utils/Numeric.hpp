@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <type_traits>
 
@@ -26,4 +27,39 @@ constexpr auto kahanSum(InputIt first, InputIt last) ->
   return sum;
 }
 
+// works for any type explicitly convertible to double, which includes the
+// boost multiprecision integers used as rank types
+template <typename T> auto approxLog2(T const &value) -> double {
+  return std::log2(static_cast<double>(value));
+}
+
+/**
+ * Converts the natural log-likelihoods of every hypothesis for one
+ * distinguishing vector into -log2 of their posterior probabilities, the
+ * scores mapToWeight expects.  Computed relative to the largest likelihood so
+ * that nothing underflows.
+ */
+template <typename InputIt, typename OutputIt>
+void logLikelihoodsToScores(InputIt first, InputIt last, OutputIt output) {
+  using T = typename std::iterator_traits<InputIt>::value_type;
+  static_assert(std::is_floating_point_v<T>,
+                "log-likelihoods must be of a floating point type");
+  if (first == last) {
+    return;
+  }
+
+  auto const maxLikelihood = *std::max_element(first, last);
+  T sum{0};
+  std::for_each(first, last, [&sum, &maxLikelihood](auto const &likelihood) {
+    sum += std::exp(likelihood - maxLikelihood);
+  });
+  auto const logSum = std::log(sum);
+  auto const ln2 = std::log(T{2});
+
+  std::transform(first, last, output,
+                 [&maxLikelihood, &logSum, &ln2](auto const &likelihood) {
+                   return (maxLikelihood - likelihood + logSum) / ln2;
+                 });
+}
+
 } /* namespace rankcpp */
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+/** \file
+ * \brief Splitting independent work items across threads
+ *
+ */
+
+namespace rankcpp {
+
+// 0 requests one thread per hardware thread
+inline auto resolveThreadCount(std::size_t threadCount) noexcept
+    -> std::size_t {
+  if (threadCount == 0) {
+    threadCount = std::max(1U, std::thread::hardware_concurrency());
+  }
+  return threadCount;
+}
+
+/**
+ * Calls fn(index, threadIndex) once for every index in [0, count), handing
+ * indexes out to threads as they become free.  If fewer threads can be
+ * started than asked for, the work is shared by those that were.  The first
+ * exception thrown by fn is rethrown once every thread has stopped.
+ */
+template <typename Function>
+void parallelFor(std::size_t count, std::size_t threadCount, Function &&fn) {
+  threadCount = std::min(resolveThreadCount(threadCount), count);
+  if (threadCount <= 1) {
+    for (std::size_t index = 0; index < count; ++index) {
+      fn(index, std::size_t{0});
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex errorMutex;
+
+  auto const worker = [&](std::size_t threadIndex) {
+    while (!failed.load(std::memory_order_relaxed)) {
+      auto const index = next.fetch_add(1, std::memory_order_relaxed);
+      if (index >= count) {
+        return;
+      }
+      try {
+        fn(index, threadIndex);
+      } catch (...) {
+        std::lock_guard<std::mutex> const lock(errorMutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount - 1);
+  for (std::size_t threadIndex = 1; threadIndex < threadCount; ++threadIndex) {
+    try {
+      threads.emplace_back(worker, threadIndex);
+    } catch (std::system_error const &) {
+      // out of threads: those already started, and this one, share the work
+      break;
+    }
+  }
+  worker(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} /* namespace rankcpp */
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/** \file
+ * \brief A small, fast and reproducible random number generator
+ *
+ */
+
+namespace rankcpp {
+
+constexpr auto splitMix64(std::uint64_t &state) noexcept -> std::uint64_t {
+  state += 0x9e3779b97f4a7c15ULL;
+  auto z = state;
+  z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31U);
+}
+
+// a seed for stream number `stream` under the same base seed, so that work
+// split across threads draws the same numbers however it is scheduled
+constexpr auto deriveSeed(std::uint64_t seed, std::uint64_t stream) noexcept
+    -> std::uint64_t {
+  std::uint64_t state = seed ^ (stream * 0xd1b54a32d192ed03ULL);
+  return splitMix64(state);
+}
+
+/**
+ * xoshiro256** by Blackman and Vigna.  Satisfies UniformRandomBitGenerator,
+ * so it can drive the standard distributions and randomKey.
+ */
+class Xoshiro256 {
+public:
+  using result_type = std::uint64_t;
+
+  constexpr explicit Xoshiro256(std::uint64_t seed) noexcept {
+    for (auto &word : state_) {
+      word = splitMix64(seed);
+    }
+  }
+
+  static constexpr auto min() noexcept -> result_type { return 0; }
+
+  static constexpr auto max() noexcept -> result_type {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr auto operator()() noexcept -> result_type {
+    auto const result = rotl(state_[1] * 5, 7) * 9;
+    auto const t = state_[1] << 17U;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = rotl(state_[3], 45);
+    return result;
+  }
+
+private:
+  std::array<std::uint64_t, 4> state_{};
+
+  static constexpr auto rotl(std::uint64_t x, unsigned k) noexcept
+      -> std::uint64_t {
+    return (x << k) | (x >> (64U - k));
+  }
+};
+
+// a uniform double in [0, 1) from the top 53 bits of a draw
+inline auto unitInterval(Xoshiro256 &rng) noexcept -> double {
+  return static_cast<double>(rng() >> 11U) * 0x1.0p-53;
+}
+
+/**
+ * A standard normal draw by the Box-Muller transform, using only the cosine
+ * half.  Unlike std::normal_distribution the algorithm is fixed, but std::log
+ * and std::cos are not correctly rounded, so the last bits can still differ
+ * between math libraries.
+ */
+inline auto standardNormal(Xoshiro256 &rng) -> double {
+  constexpr double twoPi = 6.283185307179586;
+  // 1 - u is in (0, 1], so the log is finite
+  auto const radius = std::sqrt(-2.0 * std::log(1.0 - unitInterval(rng)));
+  return radius * std::cos(twoPi * unitInterval(rng));
+}
+
+namespace detail {
+
+// every bit at or below the highest set bit of value
+constexpr auto smearRight(std::uint64_t value) noexcept -> std::uint64_t {
+  for (std::uint32_t shift = 1; shift < 64; shift *= 2) {
+    value |= value >> shift;
+  }
+  return value;
+}
+
+} /* namespace detail */
+
+/**
+ * A uniform draw from [0, bound), for the built-in unsigned types and for
+ * wider ones such as BoostBigUint, which are built 64 random bits at a time.
+ * bound must be > 0.  The raw draws are masked to the bits of bound - 1 and
+ * rejected if too large, so the result does not depend on the standard
+ * library.
+ */
+template <typename T, class RandomBitGenerator>
+auto randomBelow(T const &bound, RandomBitGenerator &rng) -> T {
+  static_assert(RandomBitGenerator::min() == 0 &&
+                    RandomBitGenerator::max() ==
+                        std::numeric_limits<std::uint64_t>::max(),
+                "randomBelow needs 64 random bits per draw");
+  auto const top = bound - 1;
+  if constexpr (std::is_integral_v<T>) {
+    static_assert(std::numeric_limits<T>::digits <= 64,
+                  "randomBelow draws built-in types from a single word");
+    auto const mask = detail::smearRight(static_cast<std::uint64_t>(top));
+    // fewer than half the draws are rejected
+    while (true) {
+      auto const value = rng() & mask;
+      if (value <= static_cast<std::uint64_t>(top)) {
+        return static_cast<T>(value);
+      }
+    }
+  } else {
+    std::uint32_t words = (std::numeric_limits<T>::digits + 63) / 64;
+    while (words > 1 && (top >> (64 * (words - 1))) == 0) {
+      --words;
+    }
+    auto const topMask = detail::smearRight(
+        static_cast<std::uint64_t>(top >> (64 * (words - 1))));
+
+    // fewer than half the draws are rejected
+    while (true) {
+      T value{rng() & topMask};
+      for (auto wi = words - 1; wi > 0; --wi) {
+        value <<= 64;
+        value |= T{rng()};
+      }
+      if (value < bound) {
+        return value;
+      }
+    }
+  }
+}
+
+} /* namespace rankcpp */
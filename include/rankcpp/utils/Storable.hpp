@@ -0,0 +1,24 @@
+#pragma once
+
+#include <type_traits>
+
+/** \file
+ * \brief Which types can be kept in files as raw bytes
+ *
+ */
+
+namespace rankcpp {
+
+/**
+ * True for types whose object representation holds their whole value, so
+ * arrays of them can live in (and be reloaded from) mapped files.  Every
+ * trivially copyable type qualifies; specialise this for others that do, as
+ * BoostBigUint.hpp does for the fixed-width boost integers.
+ */
+template <typename T>
+struct IsBitwiseStorable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+constexpr bool const IsBitwiseStorableV = IsBitwiseStorable<T>::value;
+
+} /* namespace rankcpp */
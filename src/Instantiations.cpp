@@ -0,0 +1,14 @@
+#include <rankcpp/Compiled.hpp>
+
+namespace rankcpp {
+
+#define RANKCPP_DEFINE_RANK(RankType, WeightType)                             \
+  RANKCPP_RANK_INSTANTIATIONS(template, RankType, WeightType)
+
+RANKCPP_COMPILED_TYPES(RANKCPP_DEFINE_RANK)
+RANKCPP_MAP_INSTANTIATIONS(template, std::uint32_t)
+RANKCPP_MAP_INSTANTIATIONS(template, std::uint64_t)
+
+#undef RANKCPP_DEFINE_RANK
+
+} /* namespace rankcpp */
@@ -0,0 +1,30 @@
+#include <rankcpp/Rank.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+// with ifunc support the loader runs a resolver that picks the best clone for
+// the CPU once; elsewhere only the baseline build is made
+#if defined(__has_attribute) && defined(__x86_64__) && defined(__ELF__)
+#if __has_attribute(target_clones)
+#define RANKCPP_ISA_CLONES                                                    \
+  __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#endif
+#endif
+#ifndef RANKCPP_ISA_CLONES
+#define RANKCPP_ISA_CLONES
+#endif
+
+namespace rankcpp::detail {
+
+// the buffers of a DP never overlap, which lets every clone vectorize the
+// loop without a runtime alias check
+RANKCPP_ISA_CLONES void compiledAddRanks(std::uint64_t *__restrict curr,
+                                         std::uint64_t const *__restrict prev,
+                                         std::size_t count) noexcept {
+  for (std::size_t c = 0; c < count; ++c) {
+    curr[c] += prev[c];
+  }
+}
+
+} /* namespace rankcpp::detail */
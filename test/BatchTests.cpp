@@ -0,0 +1,93 @@
+#include <rankcpp/Batch.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/Simulator.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace rankcpp {
+
+TEST_CASE("Batch#RankStatistics", "[Batch]") {
+  RankStatistics statistics({0.0, 2.0});
+  // ranks 0, 3 and 7
+  statistics.add(std::log2(1.0));
+  statistics.add(std::log2(4.0));
+  statistics.add(std::log2(8.0));
+
+  CHECK(3 == statistics.count());
+  CHECK(Approx(5.0 / 3.0) == statistics.meanLog2Guesses());
+  CHECK(Approx(std::log2(13.0 / 3.0)) == statistics.log2GuessingEntropy());
+  CHECK(Approx(1.0 / 3.0) == statistics.successRate(0));
+  CHECK(Approx(2.0 / 3.0) == statistics.successRate(1));
+
+  RankStatistics other({0.0, 2.0});
+  other.add(0.0);
+  statistics.merge(other);
+  CHECK(4 == statistics.count());
+  CHECK(Approx(0.5) == statistics.successRate(0));
+
+  CHECK_THROWS_AS(statistics.merge(RankStatistics({1.0})),
+                  std::invalid_argument);
+}
+
+TEST_CASE("Batch#rankBatch", "[Batch]") {
+  using WeightType = std::uint64_t;
+  using RankType = std::uint64_t;
+  Dimensions const dims(4, 4);
+  std::vector<std::size_t> const traceCounts = {1, 5, 50};
+  std::size_t const attacksPerCount = 4;
+
+  std::vector<Experiment<16>> experiments;
+  for (std::size_t ti = 0; ti < traceCounts.size(); ++ti) {
+    for (std::size_t attack = 0; attack < attacksPerCount; ++attack) {
+      AttackParameters params;
+      params.noise = 1.0;
+      params.traceCount = traceCounts[ti];
+      params.seed = ti * attacksPerCount + attack;
+      params.threadCount = 1;
+      auto simulated = simulateAttack<16>(dims, params);
+      experiments.push_back(
+          {traceCounts[ti], simulated.key, std::move(simulated.scores)});
+    }
+  }
+
+  BatchOptions options;
+  options.precisionBits = 10;
+  options.thresholdsBits = {0.0, 8.0, 16.0};
+  options.threadCount = 3;
+  auto const results = rankBatch<16, RankType, WeightType>(experiments,
+                                                           options);
+
+  REQUIRE(traceCounts.size() == results.size());
+  for (std::size_t ti = 0; ti < traceCounts.size(); ++ti) {
+    auto const &statistics = results.at(traceCounts[ti]);
+    CHECK(attacksPerCount == statistics.count());
+    // every key is within the 2^16 keyspace
+    CHECK(1.0 == statistics.successRate(2));
+
+    // the same summary as ranking the group one experiment at a time
+    RankStatistics expected(options.thresholdsBits);
+    for (auto const &experiment : experiments) {
+      if (experiment.group == traceCounts[ti]) {
+        auto const weights = mapToWeight<double, WeightType>(
+            experiment.scores, options.precisionBits);
+        auto const keyRank = rank<16, RankType>(experiment.key, weights);
+        expected.add(std::log2(static_cast<double>(keyRank + 1)));
+      }
+    }
+    CHECK(Approx(expected.meanLog2Guesses()) == statistics.meanLog2Guesses());
+    CHECK(Approx(expected.successRate(1)) == statistics.successRate(1));
+  }
+  CHECK(results.at(50).meanLog2Guesses() <= results.at(1).meanLog2Guesses());
+}
+
+} /* namespace rankcpp */
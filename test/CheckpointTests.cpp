@@ -0,0 +1,149 @@
+#include <rankcpp/Checkpoint.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Monitor.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace rankcpp {
+
+namespace {
+
+auto checkpointPath() -> std::string {
+  return (std::filesystem::temp_directory_path() / "rankcpp_checkpoint_test")
+      .string();
+}
+
+auto randomTable(Dimensions const &dims, std::uint32_t seed)
+    -> WeightTable<std::uint32_t> {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<std::uint32_t> weight(0, 12);
+  std::vector<std::uint32_t> weights(dims.scoresCount());
+  for (auto &w : weights) {
+    w = weight(rng);
+  }
+  return {dims, weights};
+}
+
+} // namespace
+
+TEST_CASE("Checkpoint#save and load", "[Checkpoint]") {
+  auto const path = checkpointPath();
+  Checkpoint<std::uint64_t> const saved{0x0123456789abcdefULL, 3, {5, 4, 1}};
+  saveCheckpoint(path, saved);
+
+  SECTION("round trip") {
+    auto const loaded = loadCheckpoint<std::uint64_t>(path);
+    REQUIRE(loaded.has_value());
+    CHECK(saved.tableHash == loaded->tableHash);
+    CHECK(saved.vectorsCompleted == loaded->vectorsCompleted);
+    CHECK(saved.prev == loaded->prev);
+  }
+  SECTION("another rank type") {
+    CHECK_FALSE(loadCheckpoint<std::uint32_t>(path).has_value());
+  }
+  SECTION("truncated") {
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    CHECK_FALSE(loadCheckpoint<std::uint64_t>(path).has_value());
+  }
+  SECTION("corrupted") {
+    {
+      std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+      file.seekp(-1, std::ios::end);
+      file.put('\x7f');
+    }
+    CHECK_FALSE(loadCheckpoint<std::uint64_t>(path).has_value());
+  }
+  SECTION("missing") {
+    std::filesystem::remove(path);
+    CHECK_FALSE(loadCheckpoint<std::uint64_t>(path).has_value());
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Checkpoint#ranks match the in-memory DPs", "[Checkpoint]") {
+  using RankType = std::uint64_t;
+  Dimensions const dims({3, 2, 4, 3, 2});
+  auto const table = randomTable(dims, 11);
+  CheckpointOptions options{checkpointPath(), 1};
+
+  for (std::uint32_t maxWeight = 1; maxWeight < 50; maxWeight += 7) {
+    CHECK(rank<RankType>(maxWeight, table) ==
+          rankCheckpointed<RankType>(maxWeight, table, options));
+    CHECK(rankAllWeights<RankType>(maxWeight, table) ==
+          rankAllWeightsCheckpointed<RankType>(maxWeight, table, options));
+  }
+  // a finished DP leaves no checkpoint behind
+  CHECK_FALSE(std::filesystem::exists(options.path));
+  CHECK_THROWS_AS(
+      rankCheckpointed<RankType>(std::uint32_t{0}, table, options),
+      std::invalid_argument);
+}
+
+TEST_CASE("Checkpoint#resume after cancelling", "[Checkpoint]") {
+  using RankType = std::uint64_t;
+  std::uint32_t const maxWeight = 40;
+  Dimensions const dims({3, 2, 4, 3, 2, 3});
+  auto const table = randomTable(dims, 5);
+  CheckpointOptions options{checkpointPath(), 0};
+
+  // cancelled after 3 vectors, with no checkpoint due yet
+  std::atomic<bool> cancel{false};
+  std::vector<RankProgress> reports;
+  RankMonitor monitor(
+      [&](RankProgress const &progress) {
+        reports.push_back(progress);
+        cancel = progress.vectorsCompleted == 3;
+      },
+      &cancel);
+
+  SECTION("rank") {
+    CHECK_THROWS_AS(rankCheckpointed<RankType>(maxWeight, table, options,
+                                               monitor),
+                    RankCancelled);
+    auto const saved = loadCheckpoint<RankType>(options.path);
+    REQUIRE(saved.has_value());
+    CHECK(3 == saved->vectorsCompleted);
+
+    // the resumed DP only reports the vectors it has left
+    std::vector<RankProgress> resumed;
+    RankMonitor resumedMonitor([&resumed](RankProgress const &progress) {
+      resumed.push_back(progress);
+    });
+    CHECK(rank<RankType>(maxWeight, table) ==
+          rankCheckpointed<RankType>(maxWeight, table, options,
+                                     resumedMonitor));
+    REQUIRE(3 == resumed.size());
+    CHECK(3 == resumed.front().vectorCount);
+  }
+  SECTION("rankAllWeights") {
+    CHECK_THROWS_AS(rankAllWeightsCheckpointed<RankType>(maxWeight, table,
+                                                         options, monitor),
+                    RankCancelled);
+    CHECK(rankAllWeights<RankType>(maxWeight, table) ==
+          rankAllWeightsCheckpointed<RankType>(maxWeight, table, options));
+  }
+  SECTION("a checkpoint of another table is ignored") {
+    CHECK_THROWS_AS(rankCheckpointed<RankType>(maxWeight, table, options,
+                                               monitor),
+                    RankCancelled);
+    auto const other = randomTable(dims, 6);
+    CHECK(rank<RankType>(maxWeight, other) ==
+          rankCheckpointed<RankType>(maxWeight, other, options));
+  }
+
+  std::filesystem::remove(options.path);
+}
+
+} /* namespace rankcpp */
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <vector>
 
 namespace rankcpp {
 
@@ -52,6 +53,11 @@ TEST_CASE("Dimensions# variable width constructor", "[Dimensions]") {
     Dimensions const d({4, 8});
     runTest(d);
   }
+  SECTION("vector constructor") {
+    std::vector<std::uint32_t> const widths{4, 8};
+    Dimensions const d(widths);
+    runTest(d);
+  }
 }
 
 TEST_CASE("Dimensions# asSpans", "[Dimensions]") {
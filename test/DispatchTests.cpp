@@ -0,0 +1,69 @@
+#include <rankcpp/Dispatch.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <gsl/span>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace rankcpp {
+
+TEST_CASE("Dispatch#withFixedShape", "[Dispatch]") {
+  auto const vectorCountOf = [](auto const &dims) -> std::size_t {
+    if constexpr (IsFixedDimensionsV<std::decay_t<decltype(dims)>>) {
+      return std::decay_t<decltype(dims)>::FixedVectorCount;
+    } else {
+      return 0;
+    }
+  };
+
+  CHECK(16 == withFixedShape(Dimensions(16, 8), vectorCountOf));
+  CHECK(32 == withFixedShape(Dimensions(32, 8), vectorCountOf));
+  CHECK(32 == withFixedShape(Dimensions(32, 4), vectorCountOf));
+  CHECK(8 == withFixedShape(Dimensions(8, 16), vectorCountOf));
+  CHECK(16 == withFixedShape(Dimensions(std::vector<std::uint32_t>(16, 8)),
+                             vectorCountOf));
+  // other shapes take the generic path
+  CHECK(0 == withFixedShape(Dimensions(16, 4), vectorCountOf));
+  CHECK(0 == withFixedShape(Dimensions({8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+                                        8, 8, 8, 4, 4}),
+                            vectorCountOf));
+  CHECK(0 == withFixedShape(Dimensions(32, 4), vectorCountOf,
+                            ShapeList<FixedDimensions<16, 8>>{}));
+}
+
+TEST_CASE("Dispatch#matches the generic path", "[Dispatch]") {
+  using WeightType = std::uint32_t;
+  std::mt19937 rng(4);
+  std::uniform_int_distribution<WeightType> weight(0, 3);
+
+  for (auto const &dims : {Dimensions(16, 8), Dimensions(32, 4),
+                           Dimensions(12, 8)}) {
+    std::vector<WeightType> weights(dims.scoresCount());
+    std::generate(std::begin(weights), std::end(weights),
+                  [&] { return weight(rng); });
+    WeightTable<WeightType> const table(dims, weights);
+
+    std::vector<Key<128>> keys;
+    for (std::size_t i = 0; i < 100; ++i) {
+      keys.push_back(randomKey<128>(rng));
+    }
+    std::vector<WeightType> keyWeights(keys.size());
+    weightsForKeysDispatched(table, gsl::span<Key<128> const>(keys),
+                             gsl::span<WeightType>(keyWeights));
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      CHECK(table.weightForKey(keys[i]) == keyWeights[i]);
+      CHECK(keyWeights[i] == weightForKeyDispatched(table, keys[i]));
+    }
+  }
+}
+
+} /* namespace rankcpp */
@@ -0,0 +1,157 @@
+#include <rankcpp/Enumerate.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/Unrank.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace rankcpp {
+
+TEST_CASE("enumerateKeys", "[Enumerate]") {
+  using WeightType = std::uint32_t;
+  using RankType = std::uint64_t;
+  std::mt19937 rng(49);
+  std::uniform_int_distribution<WeightType> weight(0, 6);
+
+  Dimensions const dims({3, 2, 1, 3, 1});
+  std::vector<WeightType> weights(dims.scoresCount());
+  std::generate(std::begin(weights), std::end(weights),
+                [&] { return weight(rng); });
+  WeightTable<WeightType> const table(dims, weights);
+
+  auto const valueOf = [](Key<10> const &key) {
+    return key.subkeyValue<std::uint64_t>(BitSpan{0, 10});
+  };
+
+  for (WeightType maxWeight : {1U, 5U, 9U, 14U, 40U}) {
+    SuffixCounts<RankType> const counts(maxWeight, table);
+
+    std::set<std::uint64_t> expected;
+    for (std::uint64_t value = 0; value < 1024; ++value) {
+      Key<10> key{};
+      key.setSubkeyValue(BitSpan{0, 10}, value);
+      if (table.weightForKey(key) < maxWeight) {
+        expected.insert(value);
+      }
+    }
+
+    std::vector<std::uint64_t> all;
+    auto const visited =
+        enumerateKeys<10>(table, counts, [&](Key<10> const &key) {
+          all.push_back(valueOf(key));
+          return true;
+        });
+    CHECK(visited == counts.keyCount());
+    CHECK(all.size() == expected.size());
+    CHECK(std::set<std::uint64_t>(std::cbegin(all), std::cend(all)) ==
+          expected);
+
+    // any split into ranges walks the same keys in the same order
+    std::vector<std::uint64_t> pieces;
+    auto const keyCount = counts.keyCount();
+    // past the last key is the same as up to it
+    std::vector<RankType> cuts{0, keyCount / 3, keyCount / 2, keyCount + 5};
+    for (std::size_t i = 0; i + 1 < cuts.size(); ++i) {
+      auto const count = enumerateKeys<10>(
+          table, counts, cuts[i], cuts[i + 1], [&](Key<10> const &key) {
+            pieces.push_back(valueOf(key));
+            return true;
+          });
+      CHECK(count == std::min(cuts[i + 1], keyCount) - cuts[i]);
+    }
+    CHECK(pieces == all);
+  }
+
+  SECTION("returning false stops the walk") {
+    SuffixCounts<RankType> const counts(WeightType{14}, table);
+    REQUIRE(counts.keyCount() > 3);
+    int seen = 0;
+    auto const visited =
+        enumerateKeys<10>(table, counts, [&](Key<10> const & /*unused*/) {
+          return ++seen < 3;
+        });
+    CHECK(visited == 3);
+    CHECK(seen == 3);
+    auto const none =
+        enumerateKeys<10>(table, counts, RankType{2}, RankType{2},
+                          [](Key<10> const & /*unused*/) { return true; });
+    CHECK(none == 0);
+  }
+}
+
+TEST_CASE("enumerateKeys with a predicate", "[Enumerate]") {
+  using WeightType = std::uint32_t;
+  using RankType = std::uint64_t;
+  std::mt19937 rng(50);
+  std::uniform_int_distribution<WeightType> weight(0, 6);
+
+  Dimensions const dims({3, 2, 1, 3, 1});
+  std::vector<WeightType> weights(dims.scoresCount());
+  std::generate(std::begin(weights), std::end(weights),
+                [&] { return weight(rng); });
+  WeightTable<WeightType> const table(dims, weights);
+  SuffixCounts<RankType> const counts(WeightType{16}, table);
+  auto const &spans = dims.asSpans();
+  auto const valueOf = [](Key<10> const &key) {
+    return key.subkeyValue<std::uint64_t>(BitSpan{0, 10});
+  };
+
+  // rejects vector 1 subkey 2 and vector 3 subkey 5
+  auto const rejected = [&](std::size_t depth, Key<10> const &key) {
+    auto const subkey = key.subkeyValue<std::uint64_t>(spans[depth]);
+    return (depth == 1 && subkey == 2) || (depth == 3 && subkey == 5);
+  };
+
+  std::vector<std::uint64_t> expected;
+  enumerateKeys<10>(table, counts, [&](Key<10> const &key) {
+    if (!rejected(1, key) && !rejected(3, key)) {
+      expected.push_back(valueOf(key));
+    }
+    return true;
+  });
+  REQUIRE(expected.size() < counts.keyCount());
+
+  std::size_t calls = 0;
+  std::vector<std::uint64_t> pieces;
+  std::vector<RankType> cuts{0, counts.keyCount() / 4, counts.keyCount() / 2,
+                             counts.keyCount()};
+  for (std::size_t i = 0; i + 1 < cuts.size(); ++i) {
+    enumerateKeys<10>(
+        table, counts, cuts[i], cuts[i + 1],
+        [&](Key<10> const &key) {
+          pieces.push_back(valueOf(key));
+          return true;
+        },
+        [&](std::size_t depth, Key<10> const &key) {
+          ++calls;
+          // the vectors before depth have already been accepted
+          for (std::size_t vi = 0; vi < depth; ++vi) {
+            CHECK(!rejected(vi, key));
+          }
+          return !rejected(depth, key);
+        });
+  }
+  CHECK(pieces == expected);
+  // rejected subtrees are never walked
+  CHECK(calls < counts.keyCount() * dims.vectorCount());
+
+  // rejecting everything at the first vector visits nothing
+  auto const none = enumerateKeys<10>(
+      table, counts, RankType{0}, counts.keyCount(),
+      [](Key<10> const & /*unused*/) { return true; },
+      [](std::size_t /*unused*/, Key<10> const & /*unused*/) {
+        return false;
+      });
+  CHECK(none == 0);
+}
+
+} /* namespace rankcpp */
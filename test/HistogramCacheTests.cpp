@@ -0,0 +1,142 @@
+#include <rankcpp/HistogramCache.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rankcpp {
+
+namespace {
+
+auto cacheDirectory() -> std::string {
+  return (std::filesystem::temp_directory_path() / "rankcpp_histogram_cache")
+      .string();
+}
+
+auto entryCount(std::string const &directory) -> std::size_t {
+  auto const entries = std::filesystem::directory_iterator(directory);
+  return static_cast<std::size_t>(
+      std::distance(begin(entries), end(entries)));
+}
+
+} // namespace
+
+TEST_CASE("HistogramCache#store and load", "[HistogramCache]") {
+  HistogramCache const cache(cacheDirectory());
+  std::uint64_t const key = 0x00c0ffee12345678ULL;
+  CHECK_FALSE(cache.contains(key));
+  CHECK("00c0ffee12345678.dp" ==
+        std::filesystem::path(cache.path(key)).filename().string());
+
+  cache.store(key, std::vector<std::uint64_t>{3, 2, 1});
+  CHECK(cache.contains(key));
+  CHECK(std::vector<std::uint64_t>{3, 2, 1} ==
+        cache.load<std::uint64_t>(key, 3));
+  CHECK_FALSE(cache.load<std::uint64_t>(key, 4).has_value());
+  CHECK_FALSE(cache.load<std::uint64_t>(key + 1, 3).has_value());
+
+  std::filesystem::remove_all(cache.directory());
+}
+
+TEST_CASE("HistogramCache#concurrent stores", "[HistogramCache]") {
+  HistogramCache const cache(cacheDirectory());
+  std::uint64_t const key = 41;
+  std::vector<std::thread> writers;
+  for (std::uint64_t ti = 0; ti < 4; ++ti) {
+    writers.emplace_back([&cache, ti] {
+      for (int i = 0; i < 20; ++i) {
+        cache.store(key, std::vector<std::uint64_t>(1000, ti));
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+
+  // one writer's buffer, whole, and no temporary files left behind
+  auto const entry = cache.load<std::uint64_t>(key, 1000);
+  REQUIRE(entry.has_value());
+  CHECK(std::count(std::cbegin(*entry), std::cend(*entry), entry->front()) ==
+        1000);
+  CHECK(1 == entryCount(cache.directory()));
+
+  std::filesystem::remove_all(cache.directory());
+}
+
+TEST_CASE("HistogramCache#rankCached", "[HistogramCache]") {
+  using RankType = std::uint64_t;
+  using WeightType = std::uint32_t;
+  Dimensions const dims({2, 3, 2, 2, 3, 2, 2, 3, 2, 2, 2});
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<WeightType> weight(0, 9);
+  std::vector<WeightType> weights(dims.scoresCount());
+  for (auto &w : weights) {
+    w = weight(rng);
+  }
+  HistogramCache const cache(cacheDirectory());
+  WeightType const maxWeight = 45;
+
+  SECTION("matches rank for every group size") {
+    for (std::size_t groupSize = 1; groupSize <= dims.vectorCount() + 1;
+         ++groupSize) {
+      WeightTable<WeightType> const table(dims, weights);
+      for (WeightType w = 1; w < maxWeight; w += 11) {
+        CHECK(rank<RankType>(w, table) ==
+              rankCached<RankType>(w, table, cache, groupSize));
+      }
+    }
+  }
+  SECTION("reuses the groups that did not change") {
+    WeightTable<WeightType> const table(dims, weights);
+    auto const expected = rank<RankType>(maxWeight, table);
+    CHECK(expected == rankCached<RankType>(maxWeight, table, cache, 2));
+    auto const entries = entryCount(cache.directory());
+
+    // an identical table is answered from the cache alone
+    CHECK(expected == rankCached<RankType>(maxWeight, table, cache, 2));
+    CHECK(entries == entryCount(cache.directory()));
+
+    // changing one vector only recomputes around its group
+    for (std::size_t vi = 0; vi < dims.vectorCount(); ++vi) {
+      auto changed = weights;
+      changed[dims.scoresBeforeCount(vi)] += 1;
+      WeightTable<WeightType> const changedTable(dims, changed);
+      auto const before = entryCount(cache.directory());
+      CHECK(rank<RankType>(maxWeight, changedTable) ==
+            rankCached<RankType>(maxWeight, changedTable, cache, 2));
+      CHECK(entryCount(cache.directory()) - before <= 3);
+    }
+  }
+  SECTION("an unreadable entry is recomputed") {
+    WeightTable<WeightType> const table(dims, weights);
+    auto const expected = rankCached<RankType>(maxWeight, table, cache, 3);
+    for (auto const &entry :
+         std::filesystem::directory_iterator(cache.directory())) {
+      std::filesystem::resize_file(entry.path(), 60);
+    }
+    CHECK(expected == rankCached<RankType>(maxWeight, table, cache, 3));
+  }
+  SECTION("bad arguments") {
+    WeightTable<WeightType> const table(dims, weights);
+    CHECK_THROWS_AS(rankCached<RankType>(WeightType{0}, table, cache),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(rankCached<RankType>(maxWeight, table, cache, 0),
+                    std::invalid_argument);
+  }
+
+  std::filesystem::remove_all(cache.directory());
+}
+
+} /* namespace rankcpp */
@@ -0,0 +1,77 @@
+#include <rankcpp/ImportanceSampling.hpp>
+
+#include <rankcpp/BoostBigUint.hpp>
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace rankcpp {
+
+TEST_CASE("rankImportanceSampled matches rank", "[ImportanceSampling]") {
+  using WeightType = std::uint32_t;
+  using RankType = BoostBigUint<256>;
+  std::mt19937 rng(47);
+  std::uniform_int_distribution<WeightType> weight(0, 63);
+
+  Dimensions const dims(16, 8);
+  std::vector<WeightType> weights(dims.scoresCount());
+  std::generate(std::begin(weights), std::end(weights),
+                [&] { return weight(rng); });
+  WeightTable<WeightType> const table(dims, weights);
+
+  ImportanceSamplingOptions options;
+  options.sampleCount = 1U << 16U;
+  options.seed = 5;
+  for (WeightType maxWeight : {80U, 160U, 320U, 640U, 1000U}) {
+    auto const exact = log2(rank<RankType>(maxWeight, table));
+    auto const estimate = rankImportanceSampled(maxWeight, table, options);
+    CHECK(estimate.sampleCount == options.sampleCount);
+    CHECK(estimate.hits > 0);
+    CHECK(estimate.log2Lower <= estimate.log2Rank);
+    CHECK(estimate.log2Rank <= estimate.log2Upper);
+    CHECK(std::abs(estimate.log2Rank - exact) < 0.25);
+  }
+}
+
+TEST_CASE("rankImportanceSampled is reproducible", "[ImportanceSampling]") {
+  using WeightType = std::uint32_t;
+  Dimensions const dims(8, 4);
+  std::vector<WeightType> weights(dims.scoresCount());
+  std::mt19937 rng(48);
+  std::uniform_int_distribution<WeightType> weight(0, 9);
+  std::generate(std::begin(weights), std::end(weights),
+                [&] { return weight(rng); });
+  WeightTable<WeightType> const table(dims, weights);
+
+  ImportanceSamplingOptions options;
+  options.sampleCount = 50000;
+  options.seed = 9;
+  options.threadCount = 1;
+  auto const single = rankImportanceSampled(WeightType{20}, table, options);
+  options.threadCount = 4;
+  auto const many = rankImportanceSampled(WeightType{20}, table, options);
+  CHECK(single.log2Rank == many.log2Rank);
+  CHECK(single.log2Upper == many.log2Upper);
+  CHECK(single.hits == many.hits);
+
+  // no key is lighter than the lightest key
+  auto const none = rankImportanceSampled(WeightType{0}, table, options);
+  CHECK(none.hits == 0);
+  CHECK(std::isinf(none.log2Rank));
+
+  options.sampleCount = 0;
+  CHECK_THROWS_AS(rankImportanceSampled(WeightType{20}, table, options),
+                  std::invalid_argument);
+}
+
+} /* namespace rankcpp */
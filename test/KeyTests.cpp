@@ -1,6 +1,7 @@
 #include <rankcpp/Key.hpp>
 
 #include <rankcpp/BitSpan.hpp>
+#include <rankcpp/utils/Bits.hpp>
 
 #include <catch2/catch.hpp>
 
@@ -10,7 +11,10 @@
 #include <array>
 #include <iterator>
 #include <random>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace rankcpp {
 
@@ -113,6 +117,11 @@ TEST_CASE("Key# subkeyValue (single byte)", "[Key]") {
     auto const actual = key.subkeyValue<std::uint64_t>(BitSpan{0, 8});
     CHECK(expected == actual);
   }
+  SECTION("compile time") {
+    constexpr Key<16> key(std::array<std::uint8_t, 2>{0x07, 0x09});
+    static_assert(key.subkeyValue<8, 8>() == 9);
+    CHECK(7 == key.subkeyValue<0, 8, std::uint8_t>());
+  }
 }
 
 TEST_CASE("Key# subkeyValue (two bytes)", "[Key]") {
@@ -138,6 +147,94 @@ TEST_CASE("Key# subkeyValue (truncated)", "[Key]") {
   std::uint64_t const expected = 9;
   auto const actual = key.subkeyValue<std::uint64_t>(BitSpan{6, 4});
   CHECK(expected == actual);
+  CHECK(expected == key.subkeyValue<6, 4>());
+  CHECK_THROWS_AS(key.subkeyValue<std::uint64_t>(BitSpan{10, 7}),
+                  std::out_of_range);
+}
+
+TEST_CASE("Key# subkeyValue (unaligned, matches bitwise)", "[Key]") {
+  std::mt19937 rng(11);
+  auto const key = randomKey<256>(rng);
+  auto const bitwise = [&key](BitSpan subkey) {
+    std::uint64_t value{0};
+    for (std::uint32_t bit = subkey.start(); bit <= subkey.end(); ++bit) {
+      auto const bitValue = (key.asBytes()[bit / 8] >> (bit % 8)) & 1U;
+      value |= std::uint64_t{bitValue} << (bit - subkey.start());
+    }
+    return value;
+  };
+
+  for (std::uint32_t start = 0; start < 16; ++start) {
+    for (std::uint32_t count : {1U, 5U, 8U, 13U, 32U, 57U, 63U, 64U}) {
+      BitSpan const subkey(start + 170, count);
+      CHECK(bitwise(subkey) == key.subkeyValue<std::uint64_t>(subkey));
+    }
+  }
+  CHECK(bitwise(BitSpan{3, 64}) == key.subkeyValue<3, 64, std::uint64_t>());
+}
+
+TEST_CASE("Key# setSubkeyValue", "[Key]") {
+  std::mt19937 rng(12);
+  auto const original = randomKey<256>(rng);
+
+  for (std::uint32_t start = 0; start < 16; ++start) {
+    for (std::uint32_t count : {1U, 5U, 8U, 13U, 32U, 57U, 64U}) {
+      auto key = original;
+      BitSpan const subkey(start + 170, count);
+      auto const value = std::uniform_int_distribution<std::uint64_t>()(rng);
+      key.setSubkeyValue(subkey, value);
+      CHECK((value & lowBitsMask(count)) ==
+            key.subkeyValue<std::uint64_t>(subkey));
+      // every bit outside the span is untouched
+      for (std::uint32_t bit = 0; bit < 256; ++bit) {
+        if (bit < subkey.start() || bit > subkey.end()) {
+          REQUIRE(original.subkeyValue<std::uint64_t>(BitSpan{bit, 1}) ==
+                  key.subkeyValue<std::uint64_t>(BitSpan{bit, 1}));
+        }
+      }
+    }
+  }
+
+  Key<11> truncated("0000");
+  truncated.setSubkeyValue(BitSpan{6, 4}, 0xFF);
+  CHECK(truncated.asBytes()[0] == 0xC0);
+  CHECK(truncated.asBytes()[1] == 0x03);
+  CHECK_THROWS_AS(truncated.setSubkeyValue(BitSpan{10, 7}, 0),
+                  std::out_of_range);
+}
+
+TEST_CASE("Key# parseHexKeys / writeHexKeys", "[Key]") {
+  std::mt19937 rng(5);
+  std::vector<Key<40>> keys(200);
+  std::generate(std::begin(keys), std::end(keys),
+                [&rng]() { return randomKey<40>(rng); });
+
+  std::ostringstream os;
+  writeHexKeys(os, gsl::span<Key<40> const>(keys));
+  auto const text = os.str();
+  CHECK(keys.size() * 11 == text.size());
+  CHECK(keys.size() == hexKeyCount(text));
+
+  std::vector<Key<40>> parsed(keys.size());
+  CHECK(keys.size() == parseHexKeys(text, gsl::span<Key<40>>(parsed)));
+  for (std::size_t ki = 0; ki < keys.size(); ++ki) {
+    CHECK(keys[ki].asBytes() == parsed[ki].asBytes());
+  }
+
+  SECTION("blank lines and CRLF") {
+    std::string const crlf = "0001020304\r\n\n0506070809\r\n";
+    CHECK(2 == hexKeyCount(crlf));
+    CHECK(2 == parseHexKeys(crlf, gsl::span<Key<40>>(parsed)));
+    CHECK(0x09 == parsed[1].asBytes()[4]);
+  }
+  SECTION("errors") {
+    CHECK_THROWS_AS(parseHexKeys(text, gsl::span<Key<40>>(parsed.data(), 199)),
+                    std::length_error);
+    CHECK_THROWS_AS(parseHexKeys("00010203\n", gsl::span<Key<40>>(parsed)),
+                    std::length_error);
+    CHECK_THROWS_AS(parseHexKeys("000102030z\n", gsl::span<Key<40>>(parsed)),
+                    std::invalid_argument);
+  }
 }
 
 } /* namespace rankcpp */
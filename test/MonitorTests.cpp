@@ -0,0 +1,88 @@
+#include <rankcpp/Monitor.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace rankcpp {
+
+TEST_CASE("Monitor#progress", "[Monitor]") {
+  using WeightType = std::uint64_t;
+  using RankType = std::uint32_t;
+  Dimensions const dims(3, 2);
+  WeightTable<WeightType> const table(dims,
+                                      {1, 2, 4, 1, 1, 3, 4, 1, 1, 1, 2, 2});
+  WeightType const keyWeight = 7;
+
+  std::vector<RankProgress> reports;
+  RankMonitor monitor([&reports](RankProgress const &progress) {
+    reports.push_back(progress);
+  });
+
+  SECTION("rank") {
+    CHECK(42 == rank<RankType>(keyWeight, table, monitor));
+  }
+  SECTION("rankLowMem") {
+    CHECK(42 == rankLowMem<RankType>(keyWeight, table, monitor));
+  }
+  SECTION("rankAllWeights") {
+    auto const all = rankAllWeights<RankType>(WeightType{11}, table, monitor);
+    CHECK(64 == all.back());
+  }
+
+  REQUIRE(3 == reports.size());
+  for (std::size_t i = 0; i < reports.size(); ++i) {
+    CHECK(i + 1 == reports[i].vectorsCompleted);
+    CHECK(3 == reports[i].vectorCount);
+    CHECK(0 < reports[i].operations);
+    CHECK(0 < reports[i].bytesTouched);
+    if (i > 0) {
+      CHECK(reports[i - 1].operations < reports[i].operations);
+    }
+  }
+  CHECK(0.0 == reports.back().eta.count());
+}
+
+TEST_CASE("Monitor#operation count", "[Monitor]") {
+  using WeightType = std::uint64_t;
+  using RankType = std::uint32_t;
+  Dimensions const dims(2, 2);
+  WeightTable<WeightType> const table(dims, {0, 1, 3, 0, 0, 2, 3, 0});
+
+  RankMonitor monitor([](RankProgress const & /*unused*/) {});
+  CHECK(14 == rank<RankType>(WeightType{5}, table, monitor));
+  // (5 - 0) + (5 - 2) + (5 - 3) + (5 - 0) for dv1, then the 4 subkeys of dv0
+  CHECK(19 == monitor.progress().operations);
+}
+
+TEST_CASE("Monitor#cancel", "[Monitor]") {
+  using WeightType = std::uint64_t;
+  using RankType = std::uint32_t;
+  Dimensions const dims(3, 2);
+  WeightTable<WeightType> const table(dims,
+                                      {1, 2, 4, 1, 1, 3, 4, 1, 1, 1, 2, 2});
+
+  std::atomic<bool> cancel{false};
+  std::size_t calls = 0;
+  RankMonitor monitor(
+      [&](RankProgress const & /*unused*/) {
+        ++calls;
+        cancel = true;
+      },
+      &cancel);
+  CHECK_THROWS_AS(rank<RankType>(WeightType{7}, table, monitor),
+                  RankCancelled);
+  CHECK(1 == calls);
+  CHECK_THROWS_AS(rankLowMem<RankType>(WeightType{7}, table, monitor),
+                  RankCancelled);
+  CHECK_THROWS_AS(rankAllWeights<RankType>(WeightType{7}, table, monitor),
+                  RankCancelled);
+}
+
+} /* namespace rankcpp */
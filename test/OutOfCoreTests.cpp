@@ -0,0 +1,78 @@
+#include <rankcpp/OutOfCore.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/MappedFile.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace rankcpp {
+
+namespace {
+
+auto readRanks(std::string const &path) -> std::vector<std::uint64_t> {
+  MappedFile const file(path);
+  std::vector<std::uint64_t> ranks(file.size() / sizeof(std::uint64_t));
+  std::memcpy(ranks.data(), file.asBytes().data(), file.size());
+  return ranks;
+}
+
+} // namespace
+
+TEST_CASE("OutOfCore#rankAllWeightsToFile", "[OutOfCore]") {
+  using WeightType = std::uint32_t;
+  using RankType = std::uint64_t;
+  Dimensions const dims({4, 3, 5, 2});
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<WeightType> weight(0, 40);
+  std::vector<WeightType> weights(dims.scoresCount());
+  for (auto &w : weights) {
+    w = weight(rng);
+  }
+  WeightTable<WeightType> const table(dims, weights);
+
+  auto const directory =
+      std::filesystem::temp_directory_path() / "rankcpp_out_of_core_test";
+  std::filesystem::create_directories(directory);
+  auto const outputPath = (directory / "ranks").string();
+
+  OutOfCoreOptions options;
+  options.directory = directory.string();
+  SECTION("matches rankAllWeights however the buffers are blocked") {
+    for (std::size_t const blockBytes : {8, 24, 1000, 1 << 20}) {
+      options.blockBytes = blockBytes;
+      for (WeightType const maxWeight : {1U, 17U, 100U, 161U}) {
+        rankAllWeightsToFile<RankType>(maxWeight, table, outputPath, options);
+        CHECK(rankAllWeights<RankType>(maxWeight, table) ==
+              readRanks(outputPath));
+      }
+    }
+  }
+  SECTION("only the output is left behind") {
+    rankAllWeightsToFile<RankType>(WeightType{50}, table, outputPath, options);
+    std::size_t fileCount = 0;
+    for (auto const &entry : std::filesystem::directory_iterator(directory)) {
+      CHECK(outputPath == entry.path().string());
+      ++fileCount;
+    }
+    CHECK(1 == fileCount);
+  }
+  SECTION("a max weight of 0 is rejected") {
+    CHECK_THROWS_AS(rankAllWeightsToFile<RankType>(WeightType{0}, table,
+                                                   outputPath, options),
+                    std::invalid_argument);
+  }
+
+  std::filesystem::remove_all(directory);
+}
+
+} /* namespace rankcpp */
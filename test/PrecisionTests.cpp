@@ -0,0 +1,144 @@
+#include <rankcpp/Precision.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/ScoresTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace rankcpp {
+
+namespace {
+
+auto randomScores(Dimensions const &dims, std::uint32_t seed)
+    -> ScoresTable<double> {
+  std::vector<double> scores(dims.scoresCount());
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  std::generate(std::begin(scores), std::end(scores),
+                [&generator, &dist] { return dist(generator); });
+  ScoresTable<double> table(dims, scores);
+  table.normaliseVectors();
+  table.log2();
+  table.abs();
+  return table;
+}
+
+} // namespace
+
+TEST_CASE("Precision#rankAdaptive", "[Precision]") {
+  using WeightType = std::uint64_t;
+  using RankType = std::uint64_t;
+  Dimensions const dims(4, 4);
+  auto const scores = randomScores(dims, 3);
+  Key<16> const key("3c5a");
+
+  SECTION("target reached") {
+    PrecisionBudget budget;
+    budget.targetLog2Width = 0.5;
+    budget.minPrecisionBits = 2;
+    auto const result = rankAdaptive<16, RankType, WeightType>(key, scores,
+                                                               budget);
+    CHECK(PrecisionStop::TargetReached == result.reason);
+    CHECK(result.bounds.log2Width() <= 0.5);
+    CHECK(result.bounds.lower <= result.bounds.upper);
+
+    // the bounds agree with a direct run at the chosen precision
+    auto const tables = mapToWeightBounds<double, WeightType>(
+        scores, result.precisionBits);
+    auto const direct = rankBounds<16, RankType>(key, tables.floor,
+                                                 tables.ceil);
+    CHECK(direct.lower == result.bounds.lower);
+    CHECK(direct.upper == result.bounds.upper);
+  }
+  SECTION("max precision") {
+    PrecisionBudget budget;
+    budget.targetLog2Width = 0.0;
+    budget.minPrecisionBits = 2;
+    budget.maxPrecisionBits = 3;
+    auto const result = rankAdaptive<16, RankType, WeightType>(key, scores,
+                                                               budget);
+    CHECK(3 == result.precisionBits);
+  }
+  SECTION("memory budget") {
+    PrecisionBudget budget;
+    budget.targetLog2Width = 0.0;
+    budget.minPrecisionBits = 2;
+    budget.memoryBudgetBytes = 4 * 64 * sizeof(RankType);
+    auto const result = rankAdaptive<16, RankType, WeightType>(key, scores,
+                                                               budget);
+    CHECK(PrecisionStop::MemoryBudget == result.reason);
+  }
+  SECTION("time budget") {
+    // spent by the time the second step is considered, so only the minimum
+    // precision is ranked
+    PrecisionBudget budget;
+    budget.targetLog2Width = 0.0;
+    budget.minPrecisionBits = 2;
+    budget.timeBudget = std::chrono::duration<double>{0.0};
+    auto const result = rankAdaptive<16, RankType, WeightType>(key, scores,
+                                                               budget);
+    CHECK(PrecisionStop::TimeBudget == result.reason);
+    CHECK(2 == result.precisionBits);
+  }
+  SECTION("invalid budgets") {
+    PrecisionBudget budget;
+    budget.stepBits = 0;
+    CHECK_THROWS_AS((rankAdaptive<16, RankType, WeightType>(key, scores,
+                                                             budget)),
+                    std::invalid_argument);
+    budget.stepBits = 1;
+    budget.memoryBudgetBytes = 1;
+    CHECK_THROWS_AS((rankAdaptive<16, RankType, WeightType>(key, scores,
+                                                             budget)),
+                    std::invalid_argument);
+  }
+}
+
+TEST_CASE("Precision#rankProgressive", "[Precision]") {
+  using WeightType = std::uint64_t;
+  using RankType = std::uint64_t;
+  Dimensions const dims(4, 4);
+  auto const scores = randomScores(dims, 5);
+  Key<16> const key("a1b2");
+
+  SECTION("all precisions") {
+    std::vector<std::uint32_t> seen;
+    auto const last = rankProgressive<16, RankType, WeightType>(
+        key, scores, 2, 10, [&seen](RankEstimate<RankType> const &estimate) {
+          seen.push_back(estimate.precisionBits);
+          CHECK(estimate.bounds.lower <= estimate.bounds.upper);
+          return true;
+        });
+    std::vector<std::uint32_t> const expected = {2, 3, 4, 5, 6, 7, 8, 9, 10};
+    CHECK(expected == seen);
+    CHECK(10 == last.precisionBits);
+
+    auto const tables = mapToWeightBounds<double, WeightType>(scores, 10);
+    auto const direct =
+        rankBounds<16, RankType>(key, tables.floor, tables.ceil);
+    CHECK(direct.lower == last.bounds.lower);
+    CHECK(direct.upper == last.bounds.upper);
+  }
+  SECTION("cancelled") {
+    std::size_t calls = 0;
+    auto const last = rankProgressive<16, RankType, WeightType>(
+        key, scores, 4, 20,
+        [&calls](RankEstimate<RankType> const & /*unused*/) {
+          return ++calls < 3;
+        },
+        2);
+    CHECK(3 == calls);
+    CHECK(8 == last.precisionBits);
+  }
+}
+
+} /* namespace rankcpp */
@@ -0,0 +1,150 @@
+#include <rankcpp/Pruning.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/ScoresTable.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace rankcpp {
+
+namespace {
+
+// weights with the subkeys of pruned that were dropped set to weight
+auto withDropped(WeightTable<std::uint32_t> const &weights,
+                 PrunedWeightTable<std::uint32_t> const &pruned,
+                 bool lightest) -> WeightTable<std::uint32_t> {
+  auto result = weights;
+  auto const &dims = weights.dimensions();
+  for (std::size_t vi = 0; vi < dims.vectorCount(); ++vi) {
+    std::vector<bool> kept(dims.subkeyCount(vi));
+    for (auto const &entry : pruned.kept(vi)) {
+      kept[entry.subkey] = true;
+    }
+    for (std::size_t ski = 0; ski < kept.size(); ++ski) {
+      if (!kept[ski]) {
+        result(vi, ski) = lightest ? pruned.discardedWeight(vi) : 1U << 20U;
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("pruneTopK / rankPruned", "[Pruning]") {
+  using WeightType = std::uint32_t;
+  using RankType = std::uint64_t;
+  std::mt19937 rng(48);
+  std::uniform_int_distribution<WeightType> weight(0, 30);
+
+  Dimensions const dims(4, 8);
+  std::vector<WeightType> weights(dims.scoresCount());
+  std::generate(std::begin(weights), std::end(weights),
+                [&] { return weight(rng); });
+  WeightTable<WeightType> const table(dims, weights);
+
+  SECTION("keeping everything is exact") {
+    auto const pruned = pruneTopK(table, 256);
+    CHECK(pruned.keptCount() == dims.scoresCount());
+    for (WeightType maxWeight : {1U, 20U, 60U}) {
+      auto const bounds = rankPruned<RankType>(maxWeight, pruned);
+      CHECK(bounds.lower == rank<RankType>(maxWeight, table));
+      CHECK(bounds.upper == bounds.lower);
+    }
+  }
+
+  SECTION("the bounds hold and are the ranks of the extreme tables") {
+    auto const pruned = pruneTopK(table, 16);
+    CHECK(pruned.keptCount() == 4 * 16);
+    auto const lowerTable = withDropped(table, pruned, false);
+    auto const upperTable = withDropped(table, pruned, true);
+    for (std::size_t vi = 0; vi < dims.vectorCount(); ++vi) {
+      CHECK(pruned.discardedCount(vi) == 240);
+      CHECK(pruned.kept(vi).back().weight <= pruned.discardedWeight(vi));
+    }
+    for (WeightType maxWeight : {1U, 10U, 20U, 40U, 60U}) {
+      auto const exact = rank<RankType>(maxWeight, table);
+      auto const bounds = rankPruned<RankType>(maxWeight, pruned);
+      CHECK(bounds.lower <= exact);
+      CHECK(exact <= bounds.upper);
+      CHECK(bounds.lower == rank<RankType>(maxWeight, lowerTable));
+      CHECK(bounds.upper == rank<RankType>(maxWeight, upperTable));
+    }
+  }
+
+  SECTION("a 32-bit rank type") {
+    // 2^24 keys, so every count fits
+    Dimensions const small(3, 8);
+    WeightTable<WeightType> const smallTable(
+        small, std::vector<WeightType>(std::cbegin(weights),
+                                       std::cbegin(weights) +
+                                           small.scoresCount()));
+    auto const pruned = pruneTopK(smallTable, 16);
+    for (WeightType maxWeight : {1U, 10U, 20U, 60U}) {
+      auto const wide = rankPruned<RankType>(maxWeight, pruned);
+      auto const narrow = rankPruned<std::uint32_t>(maxWeight, pruned);
+      CHECK(narrow.lower == wide.lower);
+      CHECK(narrow.upper == wide.upper);
+    }
+  }
+
+  CHECK_THROWS_AS(pruneTopK(table, 0), std::invalid_argument);
+  CHECK_THROWS_AS(rankPruned<RankType>(WeightType{0}, pruneTopK(table, 4)),
+                  std::invalid_argument);
+}
+
+TEST_CASE("pruneMass", "[Pruning]") {
+  using WeightType = std::uint32_t;
+  using RankType = std::uint64_t;
+  std::mt19937 rng(49);
+  std::exponential_distribution<double> score(0.5);
+
+  // weights that are -log2 of the probabilities, scaled and rounded
+  Dimensions const dims(4, 8);
+  std::vector<double> scores(dims.scoresCount());
+  std::generate(std::begin(scores), std::end(scores),
+                [&] { return std::exp2(-score(rng)); });
+  ScoresTable<double> probabilities(dims, scores);
+  probabilities.normaliseVectors();
+  std::vector<WeightType> weights(dims.scoresCount());
+  std::transform(std::cbegin(probabilities.allScores()),
+                 std::cend(probabilities.allScores()), std::begin(weights),
+                 [](double p) {
+                   return static_cast<WeightType>(
+                       std::lround(-4 * std::log2(p)));
+                 });
+  WeightTable<WeightType> const table(dims, weights);
+
+  double const epsilon = 0.05;
+  auto const pruned = pruneMass(probabilities, table, epsilon);
+  CHECK(pruned.keptCount() < dims.scoresCount());
+  for (std::size_t vi = 0; vi < dims.vectorCount(); ++vi) {
+    double keptMass = 0;
+    for (auto const &entry : pruned.kept(vi)) {
+      keptMass += probabilities(vi, entry.subkey);
+    }
+    CHECK(1.0 - keptMass <= epsilon + 1e-9);
+  }
+  auto const exact = rank<RankType>(WeightType{60}, table);
+  auto const bounds = rankPruned<RankType>(WeightType{60}, pruned);
+  CHECK(bounds.lower <= exact);
+  CHECK(exact <= bounds.upper);
+
+  // nothing is dropped with no mass to spare
+  CHECK(pruneMass(probabilities, table, 0.0).keptCount() ==
+        dims.scoresCount());
+  CHECK_THROWS_AS(pruneMass(probabilities, table, 1.0),
+                  std::invalid_argument);
+}
+
+} /* namespace rankcpp */
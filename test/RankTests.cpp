@@ -2,14 +2,20 @@
 
 #include <rankcpp/Dimensions.hpp>
 #include <rankcpp/Key.hpp>
+#include <rankcpp/Monitor.hpp>
 #include <rankcpp/ScoresTable.hpp>
 #include <rankcpp/WeightTable.hpp>
 
 #include <catch2/catch.hpp>
 
+#include <gsl/span>
+
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <iterator>
+#include <random>
+#include <stdexcept>
 #include <vector>
 
 namespace rankcpp {
@@ -224,4 +230,133 @@ TEST_CASE("Rank#rank, rank = 0", "[Rank]") {
   }
 }
 
+TEST_CASE("Rank#rankBounds", "[Rank]") {
+  using ScoresType = double;
+  using WeightType = std::uint64_t;
+  using RankType = std::uint64_t;
+  Dimensions const dims(3, 3);
+  std::vector<ScoresType> scores(dims.scoresCount());
+
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<ScoresType> dist(0.0, 1.0);
+  std::generate(std::begin(scores), std::end(scores),
+                [&generator, &dist] { return dist(generator); });
+  ScoresTable<ScoresType> scoresTable(dims, scores);
+  scoresTable.normaliseVectors();
+  scoresTable.log2();
+  scoresTable.abs();
+
+  // the three subkeys of a 9-bit key, packed little-endian
+  auto const scoreOf = [&scoresTable](std::uint32_t value) {
+    return scoresTable(0, value & 0x7) + scoresTable(1, (value >> 3) & 0x7) +
+           scoresTable(2, (value >> 6) & 0x7);
+  };
+
+  for (std::uint32_t const keyValue : {0x000U, 0x0a5U, 0x1ffU}) {
+    Key<9> const key({static_cast<std::uint8_t>(keyValue & 0xff),
+                      static_cast<std::uint8_t>(keyValue >> 8)});
+    RankType expected{0};
+    for (std::uint32_t candidate = 0; candidate < 512; ++candidate) {
+      if (scoreOf(candidate) < scoreOf(keyValue)) {
+        ++expected;
+      }
+    }
+
+    for (std::uint32_t const precisionBits : {3U, 6U, 12U}) {
+      auto const tables =
+          mapToWeightBounds<ScoresType, WeightType>(scoresTable, precisionBits);
+      auto const bounds =
+          rankBounds<9, RankType>(key, tables.floor, tables.ceil);
+      CHECK(bounds.lower <= expected);
+      CHECK(expected <= bounds.upper);
+    }
+  }
+}
+
+TEST_CASE("Rank#rankBounds matches separate runs", "[Rank]") {
+  using WeightType = std::uint64_t;
+  using RankType = std::uint32_t;
+  Dimensions const dims({3, 2});
+  WeightTable<WeightType> const floorTable(
+      dims, {1, 1, 3, 1, 2, 1, 2, 1, 1, 2, 3, 1});
+  WeightTable<WeightType> const ceilTable(dims,
+                                          {2, 1, 4, 2, 2, 2, 3, 1, 1, 3, 3, 2});
+  for (WeightType lowerMax = 1; lowerMax < 9; ++lowerMax) {
+    for (WeightType upperMax = 1; upperMax < 9; ++upperMax) {
+      auto const bounds =
+          rankBounds<RankType>(lowerMax, upperMax, floorTable, ceilTable);
+      CHECK(rank<RankType>(lowerMax, ceilTable) == bounds.lower);
+      CHECK(rank<RankType>(upperMax, floorTable) == bounds.upper);
+    }
+  }
+  CHECK_THROWS_AS(rankBounds<RankType>(WeightType{0}, WeightType{1},
+                                       floorTable, ceilTable),
+                  std::invalid_argument);
+}
+
+TEST_CASE("Rank#rank over a table view", "[Rank]") {
+  using WeightType = std::uint64_t;
+  using RankType = std::uint64_t;
+  Dimensions const dims({3, 2});
+  std::vector<WeightType> const buffer = {1, 1, 3, 1, 2, 1, 2, 1, 1, 2, 3, 1};
+  WeightTable<WeightType> const owning(dims, buffer);
+  ConstWeightTableView<WeightType> const view(
+      dims, gsl::span<WeightType const>(buffer));
+
+  for (WeightType maxWeight = 1; maxWeight < 8; ++maxWeight) {
+    CHECK(rank<RankType>(maxWeight, owning) ==
+          rank<RankType>(maxWeight, view));
+    CHECK(rankLowMem<RankType>(maxWeight, owning) ==
+          rankLowMem<RankType>(maxWeight, view));
+  }
+  CHECK(rankAllWeights<RankType>(WeightType{8}, owning) ==
+        rankAllWeights<RankType>(WeightType{8}, view));
+
+  // mapping a view of scores gives the same weights as mapping a copy
+  std::vector<double> const scores = {1.5, 0.5, 2.0, 0.25, 3.0, 1.0, 0.1, 4.0,
+                                      2.5, 1.0, 0.75, 2.25};
+  auto const fromOwning =
+      mapToWeight<double, WeightType>(ScoresTable<double>(dims, scores), 8);
+  auto const fromView = mapToWeight<double, WeightType>(
+      ConstScoresTableView<double>(dims, gsl::span<double const>(scores)), 8);
+  CHECK(fromOwning.allWeights() == fromView.allWeights());
+}
+
+TEST_CASE("Rank#FixedDimensions", "[Rank]") {
+  using WeightType = std::uint32_t;
+  using RankType = std::uint64_t;
+  std::mt19937 rng(9);
+  std::uniform_int_distribution<WeightType> weight(0, 15);
+
+  auto const checkShape = [&](auto fixedDims) {
+    Dimensions const dims(fixedDims.vectorCount(),
+                          fixedDims.vectorWidthBits(0));
+    std::vector<WeightType> weights(dims.scoresCount());
+    std::generate(std::begin(weights), std::end(weights),
+                  [&] { return weight(rng); });
+    WeightTable<WeightType> const generic(dims, weights);
+    WeightTable<WeightType, decltype(fixedDims)> const fixed(fixedDims,
+                                                             weights);
+
+    for (WeightType maxWeight = 1; maxWeight < 60; maxWeight += 3) {
+      CHECK(rank<RankType>(maxWeight, generic) ==
+            rank<RankType>(maxWeight, fixed));
+      CHECK(rankAllWeights<RankType>(maxWeight, generic) ==
+            rankAllWeights<RankType>(maxWeight, fixed));
+    }
+
+    std::size_t reports = 0;
+    RankMonitor monitor([&reports](RankProgress const &progress) {
+      reports = progress.vectorsCompleted;
+    });
+    rank<RankType>(WeightType{20}, fixed, monitor);
+    CHECK(fixedDims.vectorCount() == reports);
+  };
+
+  checkShape(FixedDimensions<1, 3>{});
+  checkShape(FixedDimensions<4, 2>{});
+  checkShape(FixedDimensions<3, 4>{});
+  checkShape(FixedDimensions<2, 8>{});
+}
+
 } /* namespace rankcpp */
@@ -0,0 +1,87 @@
+#include <rankcpp/Sampling.hpp>
+
+#include <rankcpp/BoostBigUint.hpp>
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/Unrank.hpp>
+#include <rankcpp/WeightTable.hpp>
+#include <rankcpp/utils/Random.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace rankcpp {
+
+TEST_CASE("sampleKeys draws uniformly below the max weight", "[Sampling]") {
+  using WeightType = std::uint32_t;
+  using RankType = std::uint64_t;
+  std::mt19937 rng(47);
+  std::uniform_int_distribution<WeightType> weight(0, 4);
+
+  Dimensions const dims({3, 2, 3});
+  std::vector<WeightType> weights(dims.scoresCount());
+  std::generate(std::begin(weights), std::end(weights),
+                [&] { return weight(rng); });
+  WeightTable<WeightType> const table(dims, weights);
+
+  WeightType const maxWeight = 6;
+  SuffixCounts<RankType> const counts(maxWeight, table);
+  REQUIRE(counts.keyCount() > 1);
+
+  auto const keys = sampleKeys<8>(table, counts, 20000, 7);
+  std::map<std::uint64_t, int> hits;
+  for (auto const &key : keys) {
+    REQUIRE(table.weightForKey(key) < maxWeight);
+    ++hits[key.subkeyValue<std::uint64_t>(BitSpan{0, 8})];
+  }
+  CHECK(hits.size() == counts.keyCount());
+  auto const expected = 20000.0 / static_cast<double>(counts.keyCount());
+  for (auto const &hit : hits) {
+    CHECK(static_cast<double>(hit.second) > 0.75 * expected);
+    CHECK(static_cast<double>(hit.second) < 1.25 * expected);
+  }
+
+  // the same keys whatever the thread count
+  auto const again = sampleKeys<8>(table, counts, 20000, 7, 1);
+  CHECK(std::equal(std::cbegin(keys), std::cend(keys), std::cbegin(again),
+                   [](auto const &a, auto const &b) {
+                     return a.asBytes() == b.asBytes();
+                   }));
+}
+
+TEST_CASE("sampleKey from a tiny share of the key space", "[Sampling]") {
+  using WeightType = std::uint32_t;
+  using RankType = BoostBigUint<256>;
+  std::mt19937 rng(48);
+  std::uniform_int_distribution<WeightType> weight(0, 40);
+
+  Dimensions const dims(16, 8);
+  std::vector<WeightType> weights(dims.scoresCount());
+  std::generate(std::begin(weights), std::end(weights),
+                [&] { return weight(rng); });
+  WeightTable<WeightType> const table(dims, weights);
+
+  // far below any share rejection sampling could reach
+  WeightType const maxWeight = 30;
+  SuffixCounts<RankType> const counts(maxWeight, table);
+  REQUIRE(counts.keyCount() > 0);
+  Xoshiro256 keyRng(3);
+  for (int i = 0; i < 100; ++i) {
+    auto const key = sampleKey<128>(table, counts, keyRng);
+    CHECK(table.weightForKey(key) < maxWeight);
+  }
+
+  WeightTable<WeightType> const heavy(
+      dims, std::vector<WeightType>(dims.scoresCount(), 1));
+  SuffixCounts<RankType> const none(WeightType{1}, heavy);
+  CHECK_THROWS_AS(sampleKey<128>(heavy, none, keyRng), std::domain_error);
+}
+
+} /* namespace rankcpp */
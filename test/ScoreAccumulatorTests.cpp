@@ -0,0 +1,100 @@
+#include <rankcpp/ScoreAccumulator.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/ScoresTable.hpp>
+#include <rankcpp/utils/Numeric.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <gsl/span>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace rankcpp {
+
+TEST_CASE("ScoreAccumulator#snapshot", "[ScoreAccumulator]") {
+  Dimensions const dims({2, 3});
+  ScoreAccumulator<double> accumulator(dims, 2);
+
+  SECTION("no traces") {
+    auto const scores = accumulator.snapshot();
+    CHECK(Approx(2.0) == scores.score(0, 3));
+    CHECK(Approx(3.0) == scores.score(1, 5));
+  }
+  SECTION("matches summing then converting") {
+    std::mt19937 rng(9);
+    std::normal_distribution<double> dist(-5.0, 2.0);
+    std::size_t const traceCount = 40;
+    std::vector<double> batch(traceCount * dims.scoresCount());
+    std::generate(std::begin(batch), std::end(batch),
+                  [&]() { return dist(rng); });
+
+    // in two batches, to check the sums carry over
+    auto const half = (traceCount / 2) * dims.scoresCount();
+    accumulator.addTraces(gsl::span<double const>(batch.data(), half));
+    accumulator.addTraces(
+        gsl::span<double const>(batch.data() + half, batch.size() - half));
+    CHECK(traceCount == accumulator.traceCount(0));
+    CHECK(traceCount == accumulator.traceCount(1));
+
+    std::vector<double> sums(dims.scoresCount());
+    for (std::size_t trace = 0; trace < traceCount; ++trace) {
+      for (std::size_t si = 0; si < sums.size(); ++si) {
+        sums[si] += batch[trace * dims.scoresCount() + si];
+      }
+    }
+    std::vector<double> expected(sums.size());
+    logLikelihoodsToScores(sums.data(), sums.data() + 4, expected.data());
+    logLikelihoodsToScores(sums.data() + 4, sums.data() + 12,
+                           expected.data() + 4);
+
+    auto const scores = accumulator.snapshot();
+    for (std::size_t si = 0; si < expected.size(); ++si) {
+      CHECK(Approx(expected[si]) == scores.allScores()[si]);
+    }
+
+    // the same scores, written into a view without allocating a table
+    std::vector<double> buffer(dims.scoresCount());
+    ScoresTableView<double> view(dims, gsl::span<double>(buffer));
+    accumulator.snapshot(view);
+    CHECK(scores.allScores() == buffer);
+
+    accumulator.reset();
+    CHECK(0 == accumulator.traceCount(1));
+    CHECK(Approx(2.0) == accumulator.snapshot().score(0, 0));
+  }
+}
+
+TEST_CASE("ScoreAccumulator#addLogLikelihoods", "[ScoreAccumulator]") {
+  Dimensions const dims(2, 1);
+  ScoreAccumulator<double> accumulator(dims);
+  // two traces for vector 1, both favouring hypothesis 1
+  std::vector<double> const batch = {std::log(0.25), std::log(0.75),
+                                     std::log(0.5), std::log(0.5)};
+  accumulator.addLogLikelihoods(1, batch);
+  CHECK(0 == accumulator.traceCount(0));
+  CHECK(2 == accumulator.traceCount(1));
+
+  auto const scores = accumulator.snapshot();
+  CHECK(Approx(1.0) == scores.score(0, 0));
+  CHECK(Approx(-std::log2(0.25)) == scores.score(1, 0));
+  CHECK(Approx(-std::log2(0.75)) == scores.score(1, 1));
+
+  CHECK_THROWS_AS(accumulator.addLogLikelihoods(
+                      2, gsl::span<double const>(batch.data(), 2)),
+                  std::out_of_range);
+  CHECK_THROWS_AS(accumulator.addLogLikelihoods(
+                      0, gsl::span<double const>(batch.data(), 3)),
+                  std::length_error);
+  CHECK_THROWS_AS(
+      accumulator.addTraces(gsl::span<double const>(batch.data(), 3)),
+      std::length_error);
+}
+
+} /* namespace rankcpp */
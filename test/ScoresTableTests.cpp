@@ -4,6 +4,8 @@
 
 #include <catch2/catch.hpp>
 
+#include <gsl/span>
+
 #include <algorithm>
 #include <cstddef>
 #include <random>
@@ -261,4 +263,22 @@ TEST_CASE("ScoresTable#addScores invalid", "[ScoresTable]") {
                   std::length_error);
 }
 
+TEST_CASE("ScoresTable#views", "[ScoresTable]") {
+  Dimensions const dims(2, 2);
+  std::vector<double> buffer = {1.0, 3.0, 2.0, 2.0, 4.0, 4.0, 1.0, 7.0};
+  ScoresTableView<double> view(dims, gsl::span<double>(buffer));
+  view.normaliseVectors();
+  CHECK(Approx(0.125) == buffer[0]);
+  CHECK(Approx(0.4375) == buffer[7]);
+  CHECK(Approx(0.25) == view.score(1, 0));
+
+  ConstScoresTableView<double> const constView(
+      dims, gsl::span<double const>(buffer));
+  auto const merged = constView.mergeVectors();
+  CHECK(Approx(0.125 * 0.25) == merged.score(0, 0));
+  CHECK_THROWS_AS(constView.score(1, 4), std::out_of_range);
+  CHECK_THROWS_AS(ScoresTableView<double>(
+                      dims, gsl::span<double>(buffer.data(), 4)),
+                  std::length_error);
+}
 } /* namespace rankcpp */
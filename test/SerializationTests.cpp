@@ -0,0 +1,153 @@
+#include <rankcpp/Serialization.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/ScoresTable.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace rankcpp {
+
+namespace {
+
+auto tablePath() -> std::string {
+  return (std::filesystem::temp_directory_path() / "rankcpp_table_test")
+      .string();
+}
+
+} // namespace
+
+TEST_CASE("Serialization#scores round trip", "[Serialization]") {
+  Dimensions const dims({3, 5, 4});
+  std::vector<double> scores(dims.scoresCount());
+  std::iota(std::begin(scores), std::end(scores), 0.25);
+  ScoresTable<double> const table(dims, scores);
+  auto const path = tablePath();
+  {
+    std::ofstream file(path, std::ios::binary);
+    writeTable(file, table);
+  }
+
+  MappedTable const mapped(path);
+  CHECK(TableKind::Scores == mapped.header().kind);
+  CHECK(ElementType::Float64 == mapped.header().elementType);
+  CHECK(0 == mapped.header().precisionBits);
+  CHECK(dims.asSpans() == mapped.dimensions().asSpans());
+
+  // the payload is used in place and is aligned for any element type
+  auto const payload = mapped.payload<double>();
+  CHECK(0 == reinterpret_cast<std::uintptr_t>(payload.data()) %
+                 PayloadAlignment);
+  CHECK(std::equal(std::cbegin(scores), std::cend(scores), payload.begin()));
+
+  auto const copy = mapped.toScoresTable<double>();
+  CHECK(scores == copy.allScores());
+  CHECK_THROWS_AS(mapped.payload<float>(), std::invalid_argument);
+  CHECK_THROWS_AS(mapped.toWeightTable<std::uint64_t>(), std::invalid_argument);
+
+  std::filesystem::remove(path);
+}
+
+TEMPLATE_TEST_CASE("Serialization#weights round trip", "[Serialization]",
+                   std::uint64_t, std::uint32_t, std::uint16_t, std::uint8_t) {
+  Dimensions const dims(3, 2);
+  WeightTable<TestType> const table(dims, {4, 3, 1, 1, 6, 4, 3, 1, 5, 7, 8, 9});
+  auto const path = tablePath();
+  {
+    std::ofstream file(path, std::ios::binary);
+    writeTable(file, table, 12);
+  }
+
+  MappedTable const mapped(path);
+  CHECK(TableKind::Weights == mapped.header().kind);
+  CHECK(elementTypeOf<TestType>() == mapped.header().elementType);
+  CHECK(12 == mapped.header().precisionBits);
+  CHECK(table.allWeights() == mapped.toWeightTable<TestType>().allWeights());
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Serialization#invalid files", "[Serialization]") {
+  Dimensions const dims(2, 2);
+  WeightTable<std::uint32_t> const table(dims, {1, 2, 3, 4, 5, 6, 7, 8});
+  std::ostringstream os;
+  writeTable(os, table);
+  auto const good = os.str();
+  REQUIRE(PayloadAlignment + 8 * sizeof(std::uint32_t) == good.size());
+
+  auto const read = [](std::string const &file) {
+    return readTableHeader(gsl::span<std::uint8_t const>(
+        reinterpret_cast<std::uint8_t const *>(file.data()), file.size()));
+  };
+  CHECK_NOTHROW(read(good));
+
+  SECTION("magic") {
+    auto bad = good;
+    bad[0] = 'X';
+    CHECK_THROWS_AS(read(bad), std::runtime_error);
+  }
+  SECTION("version") {
+    auto bad = good;
+    bad[8] = 2;
+    CHECK_THROWS_AS(read(bad), std::runtime_error);
+  }
+  SECTION("element type") {
+    auto bad = good;
+    bad[17] = 42;
+    CHECK_THROWS_AS(read(bad), std::runtime_error);
+  }
+  SECTION("span") {
+    auto bad = good;
+    bad[48] = 1;
+    CHECK_THROWS_AS(read(bad), std::runtime_error);
+  }
+  SECTION("dimensions too large to count") {
+    // with an empty payload, which the wrapped sizes would have matched
+    auto bad = good;
+    std::fill(std::begin(bad) + 40, std::begin(bad) + 48, '\0');
+    for (char const width : {63, 62}) {
+      bad[52] = width;
+      bad[56] = width;
+      bad[60] = width;
+      CHECK_THROWS_AS(read(bad), std::runtime_error);
+    }
+  }
+  SECTION("truncated") {
+    CHECK_THROWS_AS(read(good.substr(0, good.size() - 1)),
+                    std::runtime_error);
+    CHECK_THROWS_AS(read(good.substr(0, 20)), std::runtime_error);
+  }
+}
+
+TEST_CASE("Serialization#mapped views", "[Serialization]") {
+  Dimensions const dims(2, 3);
+  WeightTable<std::uint32_t> const table(
+      dims, {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8, 9, 7, 9, 3});
+  auto const path = tablePath();
+  {
+    std::ofstream file(path, std::ios::binary);
+    writeTable(file, table);
+  }
+
+  MappedTable const mapped(path);
+  auto const view = mapped.weightsView<std::uint32_t>();
+  CHECK(mapped.payload<std::uint32_t>().data() == view.allWeights().data());
+  CHECK(rank<std::uint64_t>(std::uint32_t{10}, table) ==
+        rank<std::uint64_t>(std::uint32_t{10}, view));
+  CHECK_THROWS_AS(mapped.scoresView<float>(), std::invalid_argument);
+
+  std::filesystem::remove(path);
+}
+} /* namespace rankcpp */
@@ -0,0 +1,61 @@
+#include <rankcpp/Simulator.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+namespace rankcpp {
+
+TEST_CASE("Simulator#simulateAttack", "[Simulator]") {
+  Dimensions const dims(4, 4);
+  AttackParameters params;
+  params.noise = 0.5;
+  params.traceCount = 200;
+  params.seed = 42;
+
+  auto const attack = simulateAttack<16>(dims, params);
+  auto const &scores = attack.scores;
+
+  SECTION("scores are -log2 posteriors") {
+    for (auto vi : dims.vectorRange()) {
+      double sum = 0.0;
+      for (auto ski : dims.asSpans()[vi].subkeyRange()) {
+        CHECK(scores(vi, ski) >= 0.0);
+        sum += std::pow(2.0, -scores(vi, ski));
+      }
+      CHECK(1.0 == Approx(sum));
+    }
+  }
+  SECTION("deterministic for any thread count") {
+    params.threadCount = 1;
+    auto const single = simulateAttack<16>(dims, params);
+    params.threadCount = 3;
+    auto const multi = simulateAttack<16>(dims, params);
+    CHECK(attack.key.asBytes() == single.key.asBytes());
+    CHECK(single.key.asBytes() == multi.key.asBytes());
+    CHECK(single.scores.allScores() == multi.scores.allScores());
+    CHECK(scores.allScores() == single.scores.allScores());
+  }
+  SECTION("different seeds differ") {
+    params.seed = 43;
+    auto const other = simulateAttack<16>(dims, params);
+    CHECK(scores.allScores() != other.scores.allScores());
+  }
+  SECTION("low noise recovers the key") {
+    auto const weights = mapToWeight<double, std::uint64_t>(scores, 12);
+    CHECK(0 == rank<16, std::uint64_t>(attack.key, weights));
+  }
+  SECTION("invalid parameters") {
+    CHECK_THROWS_AS(simulateAttack<8>(dims, params), std::invalid_argument);
+    params.noise = 0.0;
+    CHECK_THROWS_AS(simulateAttack<16>(dims, params), std::invalid_argument);
+  }
+}
+
+} /* namespace rankcpp */
@@ -0,0 +1,90 @@
+#include <rankcpp/Unrank.hpp>
+
+#include <rankcpp/Dimensions.hpp>
+#include <rankcpp/Key.hpp>
+#include <rankcpp/Rank.hpp>
+#include <rankcpp/WeightTable.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace rankcpp {
+
+TEST_CASE("SuffixCounts", "[Unrank]") {
+  using WeightType = std::uint32_t;
+  using RankType = std::uint64_t;
+  std::mt19937 rng(45);
+  std::uniform_int_distribution<WeightType> weight(0, 6);
+
+  Dimensions const dims(6, 4);
+  std::vector<WeightType> weights(dims.scoresCount());
+  std::generate(std::begin(weights), std::end(weights),
+                [&] { return weight(rng); });
+  WeightTable<WeightType> const table(dims, weights);
+
+  WeightType const maxWeight = 20;
+  SuffixCounts<RankType> const counts(maxWeight, table);
+  CHECK(counts.keyCount() == rank<RankType>(maxWeight, table));
+  auto const all = rankAllWeights<RankType>(maxWeight, table);
+  for (WeightType w = 1; w <= maxWeight; ++w) {
+    CHECK(counts.below(0, w) == all[w - 1]);
+  }
+  CHECK(counts.below(0, 0) == 0);
+  CHECK(counts.below(dims.vectorCount(), 1) == 1);
+  CHECK(counts.exactly(dims.vectorCount(), 0) == 1);
+  CHECK(counts.exactly(dims.vectorCount(), 1) == 0);
+  CHECK_THROWS_AS(counts.below(0, maxWeight + 1), std::out_of_range);
+  CHECK_THROWS_AS(SuffixCounts<RankType>(WeightType{0}, table),
+                  std::invalid_argument);
+}
+
+TEST_CASE("unrank", "[Unrank]") {
+  using WeightType = std::uint32_t;
+  using RankType = std::uint64_t;
+  std::mt19937 rng(46);
+  std::uniform_int_distribution<WeightType> weight(0, 5);
+
+  Dimensions const dims({2, 3, 1, 2});
+  std::vector<WeightType> weights(dims.scoresCount());
+  std::generate(std::begin(weights), std::end(weights),
+                [&] { return weight(rng); });
+  WeightTable<WeightType> const table(dims, weights);
+
+  // every key of the 8 bits, in the rank order
+  using Entry = std::tuple<WeightType, std::vector<std::uint64_t>, Key<8>>;
+  std::vector<Entry> expected;
+  for (std::uint64_t value = 0; value < 256; ++value) {
+    Key<8> key{};
+    key.setSubkeyValue(BitSpan{0, 8}, value);
+    std::vector<std::uint64_t> subkeys;
+    for (auto const &span : dims.asSpans()) {
+      subkeys.push_back(key.subkeyValue<std::uint64_t>(span));
+    }
+    expected.emplace_back(table.weightForKey(key), subkeys, key);
+  }
+  std::sort(std::begin(expected), std::end(expected),
+            [](Entry const &a, Entry const &b) {
+              return std::tie(std::get<0>(a), std::get<1>(a)) <
+                     std::tie(std::get<0>(b), std::get<1>(b));
+            });
+
+  for (WeightType maxWeight : {1U, 3U, 7U, 12U, 21U}) {
+    SuffixCounts<RankType> const counts(maxWeight, table);
+    for (RankType index = 0; index < counts.keyCount(); ++index) {
+      auto const key = unrank<8>(index, table, counts);
+      CHECK(key.asBytes() == std::get<2>(expected[index]).asBytes());
+      CHECK(table.weightForKey(key) < maxWeight);
+    }
+    CHECK_THROWS_AS(unrank<8>(counts.keyCount(), table, counts),
+                    std::out_of_range);
+  }
+}
+
+} /* namespace rankcpp */
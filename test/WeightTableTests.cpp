@@ -5,9 +5,13 @@
 
 #include <catch2/catch.hpp>
 
+#include <gsl/span>
+
+#include <algorithm>
 #include <array>
 #include <iterator>
 #include <random>
+#include <stdexcept>
 #include <vector>
 
 namespace rankcpp {
@@ -87,6 +91,33 @@ TEMPLATE_TEST_CASE("WeightTable#get weight of key", "[WeightTable]",
   }
 }
 
+TEMPLATE_TEST_CASE("WeightTable#weightsForKeys", "[WeightTable]",
+                   std::uint64_t, std::uint32_t) {
+  // unaligned subkeys of varying widths, one straddling three bytes
+  Dimensions const dims({3, 7, 12, 5, 9});
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<TestType> dist(0, 1000);
+  WeightTable<TestType> table(dims);
+  std::generate(std::begin(table.allWeights()), std::end(table.allWeights()),
+                [&]() { return dist(rng); });
+
+  std::vector<Key<36>> keys(10000);
+  std::generate(std::begin(keys), std::end(keys),
+                [&]() { return randomKey<36>(rng); });
+
+  auto const weights =
+      table.weightsForKeys(gsl::span<Key<36> const>(keys), 3);
+  REQUIRE(keys.size() == weights.size());
+  for (std::size_t ki = 0; ki < keys.size(); ++ki) {
+    CHECK(table.weightForKey(keys[ki]) == weights[ki]);
+  }
+
+  std::vector<TestType> tooFew(keys.size() - 1);
+  CHECK_THROWS_AS(table.weightsForKeys(gsl::span<Key<36> const>(keys),
+                                       gsl::span<TestType>(tooFew)),
+                  std::length_error);
+}
+
 TEMPLATE_TEST_CASE("WeightTable#rebase (minus, 0)", "[WeightTable]",
                    std::uint64_t, std::uint32_t, std::uint16_t, std::uint8_t) {
   Dimensions const dims(3, 2);
@@ -212,4 +243,74 @@ TEMPLATE_TEST_CASE("WeightTable#mapToWeight (4 bits)", "[WeightTable]",
   CHECK(maxScore < 16);
 }
 
+TEMPLATE_TEST_CASE("WeightTable#mapToWeightBounds", "[WeightTable]",
+                   std::uint64_t, std::uint32_t, std::uint16_t) {
+  using ScoresType = double;
+  using WeightType = TestType;
+  Dimensions const dims(3, 3);
+  std::vector<ScoresType> scores(dims.scoresCount());
+
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<ScoresType> dist(0.0, 1.0);
+  std::generate(std::begin(scores), std::end(scores),
+                [&generator, &dist] { return dist(generator); });
+
+  ScoresTable<ScoresType> scoresTable(dims, scores);
+  scoresTable.normaliseVectors();
+  scoresTable.log2();
+  scoresTable.abs();
+
+  std::uint32_t const precisionBits = 6;
+  auto const bounds =
+      mapToWeightBounds<ScoresType, WeightType>(scoresTable, precisionBits);
+  auto const &floorWeights = bounds.floor.allWeights();
+  auto const &ceilWeights = bounds.ceil.allWeights();
+
+  SECTION("floor matches mapToWeight") {
+    auto const mapped =
+        mapToWeight<ScoresType, WeightType>(scoresTable, precisionBits);
+    CHECK(std::equal(std::cbegin(floorWeights), std::cend(floorWeights),
+                     std::cbegin(mapped.allWeights())));
+  }
+  SECTION("ceil is at most one above floor") {
+    CHECK(1 == *std::min_element(std::cbegin(floorWeights),
+                                 std::cend(floorWeights)));
+    CHECK(std::equal(std::cbegin(floorWeights), std::cend(floorWeights),
+                     std::cbegin(ceilWeights), [](auto floor, auto ceil) {
+                       return ceil == floor || ceil == floor + 1;
+                     }));
+  }
+}
+
+TEMPLATE_TEST_CASE("WeightTable#views", "[WeightTable]", std::uint64_t,
+                   std::uint32_t) {
+  Dimensions const dims(3, 2);
+  std::vector<TestType> buffer = {9, 3, 4, 1, 6, 4, 3, 1, 5, 7, 4, 1};
+  WeightTable<TestType> const owning(dims, buffer);
+  Key<6> const key("09");
+
+  SECTION("mutable") {
+    WeightTableView<TestType> view(dims, gsl::span<TestType>(buffer));
+    CHECK(owning.weightForKey(key) == view.weightForKey(key));
+    CHECK(owning.maximumWeight() == view.maximumWeight());
+    // transforms write through to the viewed buffer
+    view.rebase(0);
+    CHECK(0 == *std::min_element(std::cbegin(buffer), std::cend(buffer)));
+    CHECK(buffer.data() == view.allWeights().data());
+  }
+  SECTION("const") {
+    ConstWeightTableView<TestType> const view(
+        dims, gsl::span<TestType const>(buffer));
+    CHECK(owning.weightForKey(key) == view.weightForKey(key));
+    CHECK(owning.minimumWeight() == view.minimumWeight());
+    CHECK(4 == view.weight(1, 1));
+    CHECK_THROWS_AS(view.weight(2, 4), std::out_of_range);
+  }
+  SECTION("wrong length") {
+    CHECK_THROWS_AS(
+        ConstWeightTableView<TestType>(
+            dims, gsl::span<TestType const>(buffer.data(), buffer.size() - 1)),
+        std::length_error);
+  }
+}
 } /* namespace rankcpp */
@@ -0,0 +1,39 @@
+#include <rankcpp/utils/Bits.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace rankcpp {
+
+TEST_CASE("Bits #loadLe64", "[Bits]") {
+  std::array<std::uint8_t, 9> const bytes = {0x01, 0x23, 0x45, 0x67, 0x89,
+                                             0xab, 0xcd, 0xef, 0xff};
+  CHECK(0x0ULL == loadLe64(bytes.data(), 0));
+  CHECK(0x01ULL == loadLe64(bytes.data(), 1));
+  CHECK(0x452301ULL == loadLe64(bytes.data(), 3));
+  CHECK(0xefcdab8967452301ULL == loadLe64(bytes.data(), 8));
+  CHECK(0xffefcdab89674523ULL == loadLe64(bytes.data() + 1, 8));
+}
+
+TEST_CASE("Bits #lowBitsMask", "[Bits]") {
+  CHECK(0x0ULL == lowBitsMask(0));
+  CHECK(0x1ULL == lowBitsMask(1));
+  CHECK(0xfffULL == lowBitsMask(12));
+  CHECK(0xffffffffffffffffULL == lowBitsMask(64));
+}
+
+TEST_CASE("Bits #loadBitsLe", "[Bits]") {
+  std::array<std::uint8_t, 9> const bytes = {0x01, 0x23, 0x45, 0x67, 0x89,
+                                             0xab, 0xcd, 0xef, 0xff};
+  CHECK(0x1ULL == loadBitsLe(bytes.data(), bytes.size(), 0, 4));
+  CHECK(0x23ULL == loadBitsLe(bytes.data(), bytes.size(), 8, 8));
+  CHECK(0x30ULL == loadBitsLe(bytes.data(), bytes.size(), 4, 8));
+  // the last byte of the string
+  CHECK(0xfULL == loadBitsLe(bytes.data(), bytes.size(), 68, 4));
+  // 64 unaligned bits, spilling into the ninth byte
+  CHECK(0xfefcdab896745230ULL == loadBitsLe(bytes.data(), bytes.size(), 4, 64));
+}
+
+} /* namespace rankcpp */
@@ -8,6 +8,7 @@
 #include <array>
 #include <iterator>
 #include <stdexcept>
+#include <string>
 
 namespace rankcpp {
 
@@ -33,6 +34,49 @@ TEST_CASE("hexToBytes", "[Encoding]") {
   SECTION("length error") {
     CHECK_THROWS_AS(hexToBytes("0102030405", out), std::length_error);
   }
+  SECTION("odd length") {
+    hexToBytes("10203", out);
+    std::array<std::uint8_t, 3> const expected = {0x01, 0x02, 0x03};
+    CHECK(std::equal(std::cbegin(expected), std::cend(expected),
+                     std::cbegin(out)));
+  }
+  SECTION("bad characters") {
+    CHECK_THROWS_AS(hexToBytes("010g", out), std::invalid_argument);
+    CHECK_THROWS_AS(hexToBytes("0x01", out), std::invalid_argument);
+    CHECK_THROWS_AS(hexToBytes("g", out), std::invalid_argument);
+    CHECK_THROWS_AS(hexToBytes("01 02 03", out), std::invalid_argument);
+  }
+}
+
+TEST_CASE("hexToBytes (word at a time)", "[Encoding]") {
+  std::string const hex = "00112233445566778899aAbBcCdDeEfF0f1e2d3c4b5a6978";
+  std::array<std::uint8_t, 24> bytes{};
+  hexToBytes(hex, bytes);
+  std::array<std::uint8_t, 24> const expected = {
+      0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb,
+      0xcc, 0xdd, 0xee, 0xff, 0x0f, 0x1e, 0x2d, 0x3c, 0x4b, 0x5a, 0x69, 0x78};
+  CHECK(expected == bytes);
+
+  // every character that is not a hex digit is rejected within a word
+  for (int c = 0; c < 256; ++c) {
+    std::string bad = "0123456789abcdef";
+    bad[5] = static_cast<char>(c);
+    if (detail::hexDigitValue(static_cast<char>(c)) < 0) {
+      CHECK_THROWS_AS(hexToBytes(bad, bytes), std::invalid_argument);
+    } else {
+      CHECK_NOTHROW(hexToBytes(bad, bytes));
+    }
+  }
+}
+
+TEST_CASE("bytesToHex", "[Encoding]") {
+  std::array<std::uint8_t, 4> const bytes = {0x00, 0x9f, 0xa0, 0xff};
+  std::array<char, 8> chars{};
+  bytesToHex(bytes, chars);
+  CHECK("009fa0ff" == std::string(std::cbegin(chars), std::cend(chars)));
+
+  std::array<char, 7> tooSmall{};
+  CHECK_THROWS_AS(bytesToHex(bytes, tooSmall), std::length_error);
 }
 
 } /* namespace rankcpp */
\ No newline at end of file
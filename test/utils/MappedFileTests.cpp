@@ -0,0 +1,85 @@
+#include <rankcpp/utils/MappedFile.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace rankcpp {
+
+TEST_CASE("MappedFile", "[MappedFile]") {
+  auto const path =
+      (std::filesystem::temp_directory_path() / "rankcpp_mapped_file_test")
+          .string();
+  std::string const contents = "0001020304\n0506070809\n";
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << contents;
+  }
+
+  SECTION("read") {
+    MappedFile const mapped(path);
+    CHECK(contents.size() == mapped.size());
+    CHECK(contents == mapped.asText());
+    CHECK(0x30 == mapped.asBytes()[0]);
+  }
+  SECTION("move") {
+    MappedFile first(path);
+    MappedFile second(std::move(first));
+    CHECK(contents == second.asText());
+  }
+  SECTION("empty") {
+    { std::ofstream file(path, std::ios::binary | std::ios::trunc); }
+    MappedFile const mapped(path);
+    CHECK(0 == mapped.size());
+    CHECK(mapped.asText().empty());
+  }
+  SECTION("missing") {
+    CHECK_THROWS_AS(MappedFile(path + ".missing"), std::system_error);
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("WritableMappedFile", "[MappedFile]") {
+  auto const path =
+      (std::filesystem::temp_directory_path() / "rankcpp_writable_file_test")
+          .string();
+
+  SECTION("writes reach the file") {
+    {
+      WritableMappedFile file(path, 4);
+      CHECK(4 == file.size());
+      std::memcpy(file.data(), "abcd", 4);
+      file.willNeed(2, 100);
+      file.flush();
+    }
+    CHECK("abcd" == MappedFile(path).asText());
+  }
+  SECTION("an existing file is truncated") {
+    {
+      std::ofstream file(path, std::ios::binary);
+      file << "0123456789";
+    }
+    WritableMappedFile const file(path, 3);
+    CHECK(3 == std::filesystem::file_size(path));
+    CHECK(0 == file.data()[0]);
+  }
+  SECTION("empty") {
+    WritableMappedFile file(path, 0);
+    CHECK(nullptr == file.data());
+    file.flush();
+  }
+  SECTION("missing directory") {
+    CHECK_THROWS_AS(WritableMappedFile(path + ".missing/file", 8),
+                    std::system_error);
+  }
+
+  std::filesystem::remove(path);
+}
+
+} /* namespace rankcpp */
@@ -2,7 +2,11 @@
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <iterator>
+#include <vector>
 
 namespace rankcpp {
 
@@ -19,4 +23,16 @@ TEST_CASE("Numeric #kahanSum", "[Numeric]") {
   }
 }
 
+TEST_CASE("Numeric #logLikelihoodsToScores", "[Numeric]") {
+  std::vector<double> const likelihoods = {std::log(0.5), std::log(0.25),
+                                           std::log(0.125), std::log(0.125)};
+  std::vector<double> scores(likelihoods.size());
+  logLikelihoodsToScores(std::cbegin(likelihoods), std::cend(likelihoods),
+                         std::begin(scores));
+  std::vector<double> const expected = {1.0, 2.0, 3.0, 3.0};
+  CHECK(std::equal(std::cbegin(expected), std::cend(expected),
+                   std::cbegin(scores),
+                   [](auto x, auto y) -> bool { return x == Approx(y); }));
+}
+
 } /* namespace rankcpp */
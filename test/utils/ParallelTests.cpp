@@ -0,0 +1,53 @@
+#include <rankcpp/utils/Parallel.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace rankcpp {
+
+TEST_CASE("Parallel #parallelFor", "[Parallel]") {
+  std::size_t const count = 1000;
+  SECTION("every index once") {
+    for (std::size_t const threadCount : {1U, 2U, 4U, 0U}) {
+      std::vector<std::atomic<int>> visits(count);
+      parallelFor(count, threadCount,
+                  [&visits](std::size_t index, std::size_t /*unused*/) {
+                    ++visits[index];
+                  });
+      for (auto const &visit : visits) {
+        CHECK(1 == visit.load());
+      }
+    }
+  }
+  SECTION("thread indexes") {
+    std::atomic<std::size_t> maxThread{0};
+    parallelFor(count, 3,
+                [&maxThread](std::size_t /*unused*/, std::size_t threadIndex) {
+                  auto seen = maxThread.load();
+                  while (threadIndex > seen &&
+                         !maxThread.compare_exchange_weak(seen, threadIndex)) {
+                  }
+                });
+    CHECK(maxThread.load() < 3);
+  }
+  SECTION("exceptions") {
+    CHECK_THROWS_AS(parallelFor(count, 4,
+                                [](std::size_t index, std::size_t /*unused*/) {
+                                  if (index == 500) {
+                                    throw std::runtime_error("failed");
+                                  }
+                                }),
+                    std::runtime_error);
+  }
+  SECTION("no work") {
+    parallelFor(0, 4, [](std::size_t /*unused*/, std::size_t /*unused*/) {
+      FAIL("called with no work");
+    });
+  }
+}
+
+} /* namespace rankcpp */
@@ -0,0 +1,101 @@
+#include <rankcpp/utils/Random.hpp>
+
+#include <rankcpp/BoostBigUint.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace rankcpp {
+
+TEST_CASE("Random #Xoshiro256", "[Random]") {
+  SECTION("same seed, same sequence") {
+    Xoshiro256 a(7);
+    Xoshiro256 b(7);
+    for (int i = 0; i < 100; ++i) {
+      CHECK(a() == b());
+    }
+  }
+  SECTION("different seeds") {
+    Xoshiro256 a(7);
+    Xoshiro256 b(8);
+    CHECK(a() != b());
+  }
+  SECTION("constexpr") {
+    constexpr auto value = [] {
+      Xoshiro256 rng(1);
+      return rng();
+    }();
+    Xoshiro256 rng(1);
+    CHECK(value == rng());
+  }
+}
+
+TEST_CASE("Random #deriveSeed", "[Random]") {
+  CHECK(deriveSeed(1, 0) == deriveSeed(1, 0));
+  CHECK(deriveSeed(1, 0) != deriveSeed(1, 1));
+  CHECK(deriveSeed(1, 0) != deriveSeed(2, 0));
+}
+
+TEST_CASE("Random #unitInterval and #standardNormal", "[Random]") {
+  Xoshiro256 rng(31);
+  double sum = 0;
+  double sumSquares = 0;
+  for (int i = 0; i < 20000; ++i) {
+    auto const u = unitInterval(rng);
+    REQUIRE(u >= 0.0);
+    REQUIRE(u < 1.0);
+    auto const z = standardNormal(rng);
+    REQUIRE(std::isfinite(z));
+    sum += z;
+    sumSquares += z * z;
+  }
+  CHECK(std::abs(sum / 20000) < 0.05);
+  CHECK(std::abs(sumSquares / 20000 - 1.0) < 0.05);
+}
+
+TEST_CASE("Random #randomBelow", "[Random]") {
+  Xoshiro256 rng(46);
+  SECTION("built-in") {
+    std::vector<int> hits(5);
+    for (int i = 0; i < 5000; ++i) {
+      auto const value = randomBelow(std::uint64_t{5}, rng);
+      REQUIRE(value < 5);
+      ++hits[value];
+    }
+    for (auto const count : hits) {
+      CHECK(count > 800);
+    }
+    CHECK(randomBelow(std::uint8_t{1}, rng) == 0);
+    CHECK(randomBelow(std::uint64_t{1}, rng) == 0);
+    auto const full = std::numeric_limits<std::uint64_t>::max();
+    CHECK(randomBelow(full, rng) < full);
+  }
+  SECTION("wide") {
+    using RankType = BoostBigUint<256>;
+    // a bound with a single set bit above the low word
+    RankType const bound = (RankType{1} << 130) + 3;
+    RankType const half = bound / 2;
+    int belowHalf = 0;
+    for (int i = 0; i < 2000; ++i) {
+      auto const value = randomBelow(bound, rng);
+      REQUIRE(value < bound);
+      belowHalf += value < half ? 1 : 0;
+    }
+    CHECK(belowHalf > 850);
+    CHECK(belowHalf < 1150);
+
+    std::vector<int> hits(3);
+    for (int i = 0; i < 3000; ++i) {
+      ++hits[static_cast<std::size_t>(randomBelow(RankType{3}, rng))];
+    }
+    for (auto const count : hits) {
+      CHECK(count > 800);
+    }
+  }
+}
+
+} /* namespace rankcpp */